@@ -0,0 +1,107 @@
+#pragma once
+
+#include "RNSkPlatformContext.h"
+
+#include <include/core/SkFontMgr.h>
+#include <include/core/SkImageInfo.h>
+#include <include/core/SkStream.h>
+#include <include/core/SkSurface.h>
+#include <include/ports/SkFontMgr_fontconfig.h>
+#include <include/ports/SkFontScanner_FreeType.h>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+namespace margelo::nitro::RNSkiaYoga::benchmarks {
+
+// Minimal host platform context for the CPU raster benchmark. Everything the
+// draw pipeline touches (font manager, offscreen surfaces, pixel density) is
+// backed by plain Skia; device-only services throw so accidental use is loud.
+class StubPlatformContext : public RNSkia::RNSkPlatformContext {
+public:
+    explicit StubPlatformContext(float pixelDensity)
+        : RNSkia::RNSkPlatformContext(nullptr, pixelDensity)
+    {
+    }
+
+    void runOnMainThread(std::function<void()> func) override { func(); }
+
+    sk_sp<SkImage> takeScreenshotFromViewTag(size_t tag) override
+    {
+        (void)tag;
+        return nullptr;
+    }
+
+    void performStreamOperation(
+        const std::string& sourceUri,
+        const std::function<void(std::unique_ptr<SkStreamAsset>)>& op) override
+    {
+        op(SkStream::MakeFromFile(sourceUri.c_str()));
+    }
+
+    void raiseError(const std::exception& err) override { throw std::runtime_error(err.what()); }
+
+    sk_sp<SkSurface> makeOffscreenSurface(int width, int height, bool useP3ColorSpace = false) override
+    {
+        (void)useP3ColorSpace;
+        return SkSurfaces::Raster(SkImageInfo::MakeN32Premul(width, height));
+    }
+
+    std::shared_ptr<RNSkia::WindowContext> makeContextFromNativeSurface(void* surface, int width, int height, bool useP3ColorSpace = false) override
+    {
+        (void)surface;
+        (void)width;
+        (void)height;
+        (void)useP3ColorSpace;
+        throw std::runtime_error("StubPlatformContext does not support native surfaces.");
+    }
+
+    sk_sp<SkImage> makeImageFromNativeBuffer(void* buffer) override
+    {
+        (void)buffer;
+        throw std::runtime_error("StubPlatformContext does not support native buffers.");
+    }
+
+    sk_sp<SkImage> makeImageFromNativeTexture(const RNSkia::TextureInfo& textureInfo, int width, int height, bool mipMapped) override
+    {
+        (void)textureInfo;
+        (void)width;
+        (void)height;
+        (void)mipMapped;
+        throw std::runtime_error("StubPlatformContext does not support native textures.");
+    }
+
+    const RNSkia::TextureInfo getTexture(sk_sp<SkSurface> surface) override
+    {
+        (void)surface;
+        throw std::runtime_error("StubPlatformContext does not support native textures.");
+    }
+
+    const RNSkia::TextureInfo getTexture(sk_sp<SkImage> image) override
+    {
+        (void)image;
+        throw std::runtime_error("StubPlatformContext does not support native textures.");
+    }
+
+    void releaseNativeBuffer(uint64_t pointer) override { (void)pointer; }
+
+    uint64_t makeNativeBuffer(sk_sp<SkImage> image) override
+    {
+        (void)image;
+        throw std::runtime_error("StubPlatformContext does not support native buffers.");
+    }
+
+    std::shared_ptr<RNSkia::RNSkVideo> createVideo(const std::string& url) override
+    {
+        (void)url;
+        throw std::runtime_error("StubPlatformContext does not support video.");
+    }
+
+    sk_sp<SkFontMgr> createFontMgr() override
+    {
+        return SkFontMgr_New_FontConfig(nullptr, SkFontScanner_Make_FreeType());
+    }
+};
+
+} // namespace margelo::nitro::RNSkiaYoga::benchmarks
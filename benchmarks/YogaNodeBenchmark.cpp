@@ -0,0 +1,315 @@
+#include "StubPlatformContext.hpp"
+
+#include "DrawingCtx.h"
+#include "ParagraphShapingPool.hpp"
+#include "PlatformContextAccessor.hpp"
+#include "RuntimeAwareCache.h"
+#include "YogaNode.hpp"
+#include <hermes/hermes.h>
+#include <include/core/SkColor.h>
+#include <include/core/SkImageInfo.h>
+#include <include/core/SkSurface.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace margelo::nitro::RNSkiaYoga::benchmarks {
+
+namespace {
+
+constexpr float kViewportWidth = 390.0f;
+constexpr float kViewportHeight = 844.0f;
+constexpr int kHitTestGridSize = 16;
+
+struct Options {
+    int iterations = 50;
+    int warmupIterations = 5;
+    std::string filter;
+};
+
+struct Scene {
+    const char* name;
+    std::function<void(const std::shared_ptr<YogaNode>&, size_t&)> build;
+};
+
+struct SceneResult {
+    size_t nodeCount = 0;
+    double layoutNsPerNode = 0.0;
+    double drawNsPerNode = 0.0;
+    double hitTestNsPerNode = 0.0;
+};
+
+std::shared_ptr<YogaNode> makeNode(NodeCommand command, const NodeStyle& style)
+{
+    auto node = std::make_shared<YogaNode>();
+    node->setCommand(std::move(command));
+    node->setStyle(style);
+    return node;
+}
+
+NodeCommand groupCommand(bool rasterize = false)
+{
+    return NodeCommand { NodeCommandKind::GROUP, GroupCommandData { .rasterize = rasterize } };
+}
+
+NodeCommand rectCommand()
+{
+    return NodeCommand { NodeCommandKind::RECT, EmptyNodeCommandData {} };
+}
+
+NodeCommand textCommand(const std::string& text)
+{
+    return NodeCommand { NodeCommandKind::TEXT, TextCommandData { .text = text } };
+}
+
+NodeCommand paragraphCommand(const std::string& text)
+{
+    return NodeCommand { NodeCommandKind::PARAGRAPH, ParagraphCommandData { .text = text } };
+}
+
+NodeStyle fixedSizeStyle(double width, double height, const char* color)
+{
+    NodeStyle style;
+    style.width = width;
+    style.height = height;
+    style.backgroundColor = std::string(color);
+    return style;
+}
+
+void insert(const std::shared_ptr<YogaNode>& parent, const std::shared_ptr<YogaNode>& child, size_t& nodeCount)
+{
+    parent->insertChild(child, std::nullopt);
+    ++nodeCount;
+}
+
+void markInteractive(const std::shared_ptr<YogaNode>& node, double eventTag)
+{
+    node->_eventTag = eventTag;
+    node->updateSelfInteractionState(true);
+}
+
+void buildDeepTree(const std::shared_ptr<YogaNode>& root, size_t& nodeCount)
+{
+    constexpr int kDepth = 256;
+    auto parent = root;
+    for (int depth = 0; depth < kDepth; ++depth) {
+        NodeStyle style;
+        style.padding = 1.0;
+        style.flexGrow = 1.0;
+        style.backgroundColor = std::string(depth % 2 == 0 ? "#1e293b" : "#334155");
+        auto child = makeNode(depth % 2 == 0 ? groupCommand() : rectCommand(), style);
+        insert(parent, child, nodeCount);
+        if (depth % 16 == 0) {
+            markInteractive(child, static_cast<double>(depth + 1));
+        }
+        parent = child;
+    }
+}
+
+void buildWideList(const std::shared_ptr<YogaNode>& root, size_t& nodeCount)
+{
+    constexpr int kRows = 2000;
+    for (int row = 0; row < kRows; ++row) {
+        NodeStyle rowStyle;
+        rowStyle.flexDirection = FlexDirection::ROW;
+        rowStyle.height = 44.0;
+        rowStyle.padding = 8.0;
+        rowStyle.backgroundColor = std::string(row % 2 == 0 ? "#f8fafc" : "#e2e8f0");
+        auto rowNode = makeNode(rectCommand(), rowStyle);
+        insert(root, rowNode, nodeCount);
+        markInteractive(rowNode, static_cast<double>(row + 1));
+
+        insert(rowNode, makeNode(rectCommand(), fixedSizeStyle(28.0, 28.0, "#0ea5e9")), nodeCount);
+        insert(rowNode, makeNode(textCommand("Row " + std::to_string(row)), NodeStyle {}), nodeCount);
+    }
+}
+
+void buildParagraphs(const std::shared_ptr<YogaNode>& root, size_t& nodeCount)
+{
+    constexpr int kParagraphs = 300;
+    for (int index = 0; index < kParagraphs; ++index) {
+        insert(
+            root,
+            makeNode(
+                paragraphCommand(
+                    "Paragraph " + std::to_string(index) +
+                    ": the quick brown fox jumps over the lazy dog while the layout engine wraps this line."),
+                NodeStyle {}),
+            nodeCount);
+    }
+}
+
+void buildRasterizedGroups(const std::shared_ptr<YogaNode>& root, size_t& nodeCount)
+{
+    constexpr int kGroups = 48;
+    constexpr int kChildrenPerGroup = 24;
+    // Keep the viewport size from makeRoot so the groups wrap at 390 points.
+    NodeStyle containerStyle = root->_style;
+    containerStyle.flexDirection = FlexDirection::ROW;
+    containerStyle.flexWrap = FlexWrap::WRAP;
+    root->setStyle(containerStyle);
+
+    for (int group = 0; group < kGroups; ++group) {
+        NodeStyle groupStyle;
+        groupStyle.width = 96.0;
+        groupStyle.height = 96.0;
+        groupStyle.flexDirection = FlexDirection::ROW;
+        groupStyle.flexWrap = FlexWrap::WRAP;
+        groupStyle.borderRadius = 12.0;
+        auto groupNode = makeNode(groupCommand(true), groupStyle);
+        insert(root, groupNode, nodeCount);
+
+        for (int child = 0; child < kChildrenPerGroup; ++child) {
+            insert(groupNode, makeNode(rectCommand(), fixedSizeStyle(16.0, 16.0, child % 2 == 0 ? "#f97316" : "#22c55e")), nodeCount);
+        }
+    }
+}
+
+std::shared_ptr<YogaNode> makeRoot()
+{
+    NodeStyle style;
+    style.width = static_cast<double>(kViewportWidth);
+    style.height = static_cast<double>(kViewportHeight);
+    return makeNode(groupCommand(), style);
+}
+
+template <typename Fn>
+double measureNs(int iterations, Fn&& fn)
+{
+    const auto start = std::chrono::steady_clock::now();
+    for (int iteration = 0; iteration < iterations; ++iteration) {
+        fn(iteration);
+    }
+    const auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::nano>(end - start).count();
+}
+
+SceneResult runScene(const Scene& scene, const Options& options, SkCanvas* canvas)
+{
+    auto root = makeRoot();
+    SceneResult result;
+    result.nodeCount = 1;
+    scene.build(root, result.nodeCount);
+    // Paragraphs may be shaped in the background; measure their final layout.
+    ParagraphShapingPool::shared().waitUntilIdle();
+    root->computeLayout(std::nullopt, std::nullopt);
+
+    const auto nodes = static_cast<double>(result.nodeCount);
+    const auto iterations = std::max(1, options.iterations);
+
+    // The root has a definite style width, so only changing that style (not
+    // the owner width) dirties it. Alternating it makes Yoga run a real pass
+    // every iteration, since stretched children get a new width each time.
+    const auto rootStyle = root->_style;
+    int layoutPass = 0;
+    auto relayout = [&](int) {
+        layoutPass += 1;
+        NodeStyle style = rootStyle;
+        style.width = static_cast<double>(kViewportWidth) - static_cast<double>(layoutPass % 2);
+        root->setStyle(style);
+        root->computeLayout(std::nullopt, std::nullopt);
+    };
+    measureNs(options.warmupIterations, relayout);
+    result.layoutNsPerNode = measureNs(iterations, relayout) / (nodes * iterations);
+    root->setStyle(rootStyle);
+    root->computeLayout(std::nullopt, std::nullopt);
+
+    auto draw = [&](int) {
+        canvas->clear(SK_ColorTRANSPARENT);
+        RNSkia::DrawingCtx ctx(canvas);
+        root->renderToContext(ctx);
+    };
+    measureNs(options.warmupIterations, draw);
+    result.drawNsPerNode = measureNs(iterations, draw) / (nodes * iterations);
+
+    auto hitTest = [&](int) {
+        for (int y = 0; y < kHitTestGridSize; ++y) {
+            for (int x = 0; x < kHitTestGridSize; ++x) {
+                root->hitTestTagAt(
+                    (static_cast<float>(x) + 0.5f) * kViewportWidth / kHitTestGridSize,
+                    (static_cast<float>(y) + 0.5f) * kViewportHeight / kHitTestGridSize);
+            }
+        }
+    };
+    constexpr double kPointsPerIteration = kHitTestGridSize * kHitTestGridSize;
+    measureNs(options.warmupIterations, hitTest);
+    result.hitTestNsPerNode = measureNs(iterations, hitTest) / (nodes * iterations * kPointsPerIteration);
+
+    return result;
+}
+
+Options parseOptions(int argc, char** argv)
+{
+    Options options;
+    for (int index = 1; index < argc; ++index) {
+        const std::string arg = argv[index];
+        if (arg == "--iterations" && index + 1 < argc) {
+            options.iterations = std::atoi(argv[++index]);
+        } else if (arg == "--warmup" && index + 1 < argc) {
+            options.warmupIterations = std::atoi(argv[++index]);
+        } else if (arg == "--filter" && index + 1 < argc) {
+            options.filter = argv[++index];
+        } else {
+            std::fprintf(stderr, "usage: %s [--iterations N] [--warmup N] [--filter scene]\n", argv[0]);
+            std::exit(2);
+        }
+    }
+    return options;
+}
+
+} // namespace
+
+int run(int argc, char** argv)
+{
+    const auto options = parseOptions(argc, argv);
+
+    auto runtime = facebook::hermes::makeHermesRuntime();
+    RNJsi::BaseRuntimeAwareCache::setMainJsRuntime(runtime.get());
+    SetPlatformContext(std::make_shared<StubPlatformContext>(1.0f));
+
+    auto surface = SkSurfaces::Raster(SkImageInfo::MakeN32Premul(
+        static_cast<int>(kViewportWidth),
+        static_cast<int>(kViewportHeight)));
+    if (surface == nullptr) {
+        std::fprintf(stderr, "Unable to allocate the raster surface.\n");
+        return 1;
+    }
+
+    const std::vector<Scene> scenes = {
+        { "deep-tree", buildDeepTree },
+        { "wide-list", buildWideList },
+        { "paragraphs", buildParagraphs },
+        { "rasterized-groups", buildRasterizedGroups },
+    };
+
+    std::printf("%-20s %8s %16s %16s %16s\n", "scene", "nodes", "layout ns/node", "draw ns/node", "hitTest ns/node");
+    for (const auto& scene : scenes) {
+        if (!options.filter.empty() && options.filter != scene.name) {
+            continue;
+        }
+        const auto result = runScene(scene, options, surface->getCanvas());
+        std::printf(
+            "%-20s %8zu %16.2f %16.2f %16.2f\n",
+            scene.name,
+            result.nodeCount,
+            result.layoutNsPerNode,
+            result.drawNsPerNode,
+            result.hitTestNsPerNode);
+    }
+
+    ClearPlatformContext();
+    RNJsi::BaseRuntimeAwareCache::setMainJsRuntime(nullptr);
+    return 0;
+}
+
+} // namespace margelo::nitro::RNSkiaYoga::benchmarks
+
+int main(int argc, char** argv)
+{
+    return margelo::nitro::RNSkiaYoga::benchmarks::run(argc, argv);
+}
@@ -4,7 +4,11 @@
 #include "SharedItems/Serializable.h"
 #include "SharedItems/Synchronizable.h"
 #include <cmath>
+#include <cstring>
 #include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <unordered_map>
 
 namespace margelo::nitro::RNSkiaYoga {
 
@@ -69,8 +73,177 @@ AnimatedDoubleNativeFloatResolution resolveNativeFloatValue(const std::optional<
     return makeValidNativeFloatResolution(*value);
 }
 
+// A published sample packs the sampling generation into the top 30 bits, the
+// resolution state (offset by one so that zero means "never sampled") into the
+// next 2 bits and the float bits into the low word.
+constexpr uint32_t kGenerationBits = 30;
+constexpr uint32_t kGenerationMask = (1u << kGenerationBits) - 1;
+
+uint64_t packNativeFloatResolution(const AnimatedDoubleNativeFloatResolution& resolution, uint32_t generation)
+{
+    uint32_t bits = 0;
+    std::memcpy(&bits, &resolution.value, sizeof(bits));
+    const auto tag = static_cast<uint64_t>(resolution.state) + 1;
+    const auto header = (static_cast<uint64_t>(generation & kGenerationMask) << 2) | tag;
+    return (header << 32) | bits;
+}
+
+uint32_t unpackGeneration(uint64_t packed)
+{
+    return static_cast<uint32_t>(packed >> 34);
+}
+
+AnimatedDoubleNativeFloatResolution unpackNativeFloatResolution(uint64_t packed)
+{
+    const auto tag = (packed >> 32) & 0x3u;
+    if (tag == 0) {
+        return makeUnsetNativeFloatResolution();
+    }
+
+    const auto bits = static_cast<uint32_t>(packed);
+    float value = 0.0f;
+    std::memcpy(&value, &bits, sizeof(value));
+    return AnimatedDoubleNativeFloatResolution {
+        .state = static_cast<AnimatedDoubleNativeFloatResolutionState>(tag - 1),
+        .value = value,
+    };
+}
+
+// Whether generation a was taken after b, allowing for wrap-around.
+bool isNewerGeneration(uint32_t a, uint32_t b)
+{
+    const auto distance = (a - b) & kGenerationMask;
+    return distance != 0 && distance < (kGenerationMask >> 1);
+}
+
+std::atomic<uint32_t> sSamplingGeneration { 0 };
+
+uint32_t nextSamplingGeneration()
+{
+    return (sSamplingGeneration.fetch_add(1, std::memory_order_relaxed) + 1) & kGenerationMask;
+}
+
+// Reads the synchronizable's current value for both cell sampling and
+// resolveAnimatedSynchronizable, so the two accept the same values. Only
+// scalars are turned into a jsi::Value: they don't allocate on the runtime, so
+// this is safe from the render thread, while objects would be created on the
+// main runtime off its thread.
+std::optional<double> readSynchronizableNumber(worklets::Synchronizable& synchronizable, jsi::Runtime& runtime)
+{
+    auto serializable = synchronizable.getBlocking();
+    switch (serializable->valueType()) {
+    case worklets::Serializable::UndefinedType:
+    case worklets::Serializable::NullType:
+        return std::nullopt;
+    case worklets::Serializable::NumberType:
+        return serializable->toJSValue(runtime).asNumber();
+    default:
+        throw std::invalid_argument("AnimatedDouble synchronizable must hold a number.");
+    }
+}
+
 } // namespace
 
+AnimatedDoubleCell::AnimatedDoubleCell(std::shared_ptr<worklets::Synchronizable> synchronizable)
+    : _synchronizable(std::move(synchronizable))
+{
+}
+
+bool AnimatedDoubleCell::hasSample() const
+{
+    return _published.load(std::memory_order_acquire) != 0;
+}
+
+AnimatedDoubleNativeFloatResolution AnimatedDoubleCell::read() const
+{
+    return unpackNativeFloatResolution(_published.load(std::memory_order_acquire));
+}
+
+AnimatedDoubleNativeFloatResolution AnimatedDoubleCell::sample(jsi::Runtime& runtime) const
+{
+    try {
+        return resolveNativeFloatValue(readSynchronizableNumber(*_synchronizable, runtime));
+    } catch (...) {
+        return makeInvalidNativeFloatResolution();
+    }
+}
+
+// Cells are shared by every tree bound to the same synchronizable, and trees
+// sample on their own threads. A sample only replaces one from an older
+// generation, so publishing is idempotent and never moves a cell backwards.
+void AnimatedDoubleCell::publish(const AnimatedDoubleNativeFloatResolution& resolution, uint32_t generation)
+{
+    const auto packed = packNativeFloatResolution(resolution, generation);
+    auto current = _published.load(std::memory_order_acquire);
+    while (current == 0 || isNewerGeneration(generation, unpackGeneration(current))) {
+        if (_published.compare_exchange_weak(current, packed, std::memory_order_acq_rel, std::memory_order_acquire)) {
+            return;
+        }
+    }
+}
+
+void AnimatedDoubleCell::refresh()
+{
+    const auto generation = nextSamplingGeneration();
+    auto* runtime = RNJsi::BaseRuntimeAwareCache::getMainJsRuntime();
+    if (runtime == nullptr) {
+        return;
+    }
+
+    publish(sample(*runtime), generation);
+}
+
+std::shared_ptr<AnimatedDoubleCell> animatedDoubleCellFor(
+    const std::shared_ptr<worklets::Synchronizable>& synchronizable)
+{
+    if (!synchronizable) {
+        return nullptr;
+    }
+
+    static std::mutex mutex;
+    static std::unordered_map<const worklets::Synchronizable*, std::weak_ptr<AnimatedDoubleCell>> cells;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (auto existing = cells.find(synchronizable.get()); existing != cells.end()) {
+        if (auto cell = existing->second.lock()) {
+            return cell;
+        }
+    }
+
+    std::erase_if(cells, [](const auto& entry) {
+        return entry.second.expired();
+    });
+
+    auto cell = std::make_shared<AnimatedDoubleCell>(synchronizable);
+    cells[synchronizable.get()] = cell;
+    return cell;
+}
+
+void sampleAnimatedDoubleCells(const std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells)
+{
+    if (cells.empty()) {
+        return;
+    }
+
+    auto* runtime = RNJsi::BaseRuntimeAwareCache::getMainJsRuntime();
+    if (runtime == nullptr) {
+        return;
+    }
+
+    // The generation is taken before any read, so a batch that finishes after
+    // a newer one from another tree cannot overwrite its samples.
+    const auto generation = nextSamplingGeneration();
+    std::vector<AnimatedDoubleNativeFloatResolution> samples;
+    samples.reserve(cells.size());
+    for (const auto& cell : cells) {
+        samples.push_back(cell->sample(*runtime));
+    }
+
+    for (size_t index = 0; index < cells.size(); ++index) {
+        cells[index]->publish(samples[index], generation);
+    }
+}
+
 std::shared_ptr<worklets::Synchronizable> extractAnimatedSynchronizable(
     jsi::Runtime& runtime,
     const jsi::Value& value)
@@ -109,13 +282,19 @@ std::optional<double> resolveAnimatedSynchronizable(
         return fallback;
     }
 
-    auto blockingValue = synchronizable->getBlocking();
-    auto currentValue = blockingValue->toJSValue(*runtime);
-    return JSIConverter<std::optional<double>>::fromJSI(*runtime, currentValue);
+    return readSynchronizableNumber(*synchronizable, *runtime);
 }
 
 AnimatedDoubleNativeFloatResolution AnimatedDouble::resolveNativeFloat() const
 {
+    if (cell) {
+        if (!cell->hasSample()) {
+            // Nothing has been published for this value yet (first frame).
+            cell->refresh();
+        }
+        return cell->read();
+    }
+
     try {
         return resolveNativeFloatValue(resolve());
     } catch (...) {
@@ -9,8 +9,11 @@
 #include "RuntimeAwareCache.h"
 #include <NitroModules/JSIConverter+Optional.hpp>
 #include <jsi/jsi.h>
+#include <atomic>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <vector>
 
 namespace worklets {
 class Synchronizable;
@@ -54,9 +57,43 @@ struct AnimatedDoubleNativeFloatResolution {
     }
 };
 
+// Lock-free native snapshot of one animated value. Sampling reads the value
+// through JSI; publishing stores it in a single atomic word tagged with its
+// sampling generation, so draw code reads a complete value without touching
+// JSI and concurrent samplers from different trees never expose a stale one.
+class AnimatedDoubleCell {
+public:
+    explicit AnimatedDoubleCell(std::shared_ptr<worklets::Synchronizable> synchronizable);
+
+    const std::shared_ptr<worklets::Synchronizable>& synchronizable() const
+    {
+        return _synchronizable;
+    }
+
+    bool hasSample() const;
+    AnimatedDoubleNativeFloatResolution read() const;
+    AnimatedDoubleNativeFloatResolution sample(facebook::jsi::Runtime& runtime) const;
+    void publish(const AnimatedDoubleNativeFloatResolution& resolution, uint32_t generation);
+    // Samples and publishes right away, outside of a frame batch.
+    void refresh();
+
+private:
+    std::shared_ptr<worklets::Synchronizable> _synchronizable;
+    std::atomic<uint64_t> _published { 0 };
+};
+
+// Returns the cell shared by every AnimatedDouble bound to the same synchronizable.
+std::shared_ptr<AnimatedDoubleCell> animatedDoubleCellFor(
+    const std::shared_ptr<worklets::Synchronizable>& synchronizable);
+
+// Resolves a frame's worth of cells in one pass (one runtime lookup, one
+// blocking read per cell), then publishes them together under one generation.
+void sampleAnimatedDoubleCells(const std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells);
+
 struct AnimatedDouble {
     std::optional<double> value;
     std::shared_ptr<worklets::Synchronizable> synchronizable;
+    std::shared_ptr<AnimatedDoubleCell> cell;
 
     bool isDynamic() const
     {
@@ -68,6 +105,13 @@ struct AnimatedDouble {
         return resolveAnimatedSynchronizable(synchronizable, value);
     }
 
+    void collectCell(std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells) const
+    {
+        if (cell) {
+            cells.push_back(cell);
+        }
+    }
+
     AnimatedDoubleNativeFloatResolution resolveNativeFloat() const;
 };
 
@@ -94,8 +138,10 @@ struct JSIConverter<margelo::nitro::RNSkiaYoga::AnimatedDouble> final {
         }
 
         if (arg.isObject()) {
+            auto synchronizable = margelo::nitro::RNSkiaYoga::extractAnimatedSynchronizable(runtime, arg);
             return AnimatedDouble {
-                .synchronizable = margelo::nitro::RNSkiaYoga::extractAnimatedSynchronizable(runtime, arg),
+                .synchronizable = synchronizable,
+                .cell = margelo::nitro::RNSkiaYoga::animatedDoubleCellFor(synchronizable),
             };
         }
 
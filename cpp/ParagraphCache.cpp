@@ -0,0 +1,129 @@
+#include "ParagraphCache.hpp"
+
+#include <cstdint>
+#include <functional>
+#include <iterator>
+#include <string_view>
+#include <utility>
+
+namespace margelo::nitro::RNSkiaYoga {
+
+namespace {
+
+void hashCombine(size_t& seed, size_t value)
+{
+    seed ^= value + 0x9e3779b97f4a7c15ULL + (seed << 6) + (seed >> 2);
+}
+
+} // namespace
+
+bool sameParagraphStyle(const skia::textlayout::ParagraphStyle& a, const skia::textlayout::ParagraphStyle& b)
+{
+    return a.getTextStyle() == b.getTextStyle()
+        && a.getStrutStyle() == b.getStrutStyle()
+        && a.getTextDirection() == b.getTextDirection()
+        && a.getTextAlign() == b.getTextAlign()
+        && a.getMaxLines() == b.getMaxLines()
+        && a.getEllipsis() == b.getEllipsis()
+        && a.getEllipsisUtf16() == b.getEllipsisUtf16()
+        && a.getHeight() == b.getHeight()
+        && a.getTextHeightBehavior() == b.getTextHeightBehavior()
+        && a.hintingIsOn() == b.hintingIsOn()
+        && a.getReplaceTabCharacters() == b.getReplaceTabCharacters()
+        && a.getApplyRoundingHack() == b.getApplyRoundingHack();
+}
+
+ParagraphCache& ParagraphCache::shared()
+{
+    static ParagraphCache cache;
+    return cache;
+}
+
+// Hashes the fields that usually tell labels apart; equality is decided by
+// sameParagraphStyle.
+size_t ParagraphCache::hashKey(const std::string& text, const skia::textlayout::ParagraphStyle& style)
+{
+    size_t hash = std::hash<std::string>()(text);
+    const auto& textStyle = style.getTextStyle();
+    hashCombine(hash, std::hash<float>()(textStyle.getFontSize()));
+    hashCombine(hash, std::hash<uint32_t>()(textStyle.getColor()));
+    for (const auto& family : textStyle.getFontFamilies()) {
+        hashCombine(hash, std::hash<std::string_view>()(std::string_view(family.c_str(), family.size())));
+    }
+    hashCombine(hash, std::hash<int>()(static_cast<int>(style.getTextAlign())));
+    hashCombine(hash, std::hash<size_t>()(style.getMaxLines()));
+    const auto& strutStyle = style.getStrutStyle();
+    hashCombine(hash, std::hash<bool>()(strutStyle.getStrutEnabled()));
+    if (strutStyle.getStrutEnabled()) {
+        hashCombine(hash, std::hash<float>()(strutStyle.getFontSize()));
+        hashCombine(hash, std::hash<float>()(strutStyle.getHeight()));
+    }
+    hashCombine(hash, std::hash<int>()(static_cast<int>(style.getTextHeightBehavior())));
+    return hash;
+}
+
+std::shared_ptr<ShapedParagraph> ParagraphCache::find(const std::string& text, const skia::textlayout::ParagraphStyle& style)
+{
+    const auto hash = hashKey(text, style);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto [begin, end] = _entriesByHash.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        auto entry = it->second;
+        if (entry->text == text && sameParagraphStyle(entry->style, style)) {
+            _entries.splice(_entries.begin(), _entries, entry);
+            return entry->paragraph;
+        }
+    }
+    return nullptr;
+}
+
+void ParagraphCache::store(const std::string& text, const skia::textlayout::ParagraphStyle& style, std::shared_ptr<ShapedParagraph> paragraph)
+{
+    if (paragraph == nullptr) {
+        return;
+    }
+
+    const auto hash = hashKey(text, style);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto [begin, end] = _entriesByHash.equal_range(hash);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second->text == text && sameParagraphStyle(it->second->style, style)) {
+            eraseEntry(it->second);
+            break;
+        }
+    }
+
+    _entries.push_front(Entry { hash, text, style, std::move(paragraph) });
+    _entriesByHash.emplace(hash, _entries.begin());
+    evictToCapacity();
+}
+
+void ParagraphCache::setCapacity(size_t capacity)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _capacity = capacity;
+    evictToCapacity();
+}
+
+void ParagraphCache::eraseEntry(std::list<Entry>::iterator entry)
+{
+    const auto [begin, end] = _entriesByHash.equal_range(entry->hash);
+    for (auto it = begin; it != end; ++it) {
+        if (it->second == entry) {
+            _entriesByHash.erase(it);
+            break;
+        }
+    }
+    _entries.erase(entry);
+}
+
+void ParagraphCache::evictToCapacity()
+{
+    while (_entries.size() > _capacity) {
+        eraseEntry(std::prev(_entries.end()));
+    }
+}
+
+} // namespace margelo::nitro::RNSkiaYoga
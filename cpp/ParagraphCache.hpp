@@ -0,0 +1,79 @@
+#pragma once
+
+#include "JsiSkParagraph.h"
+#include <modules/skparagraph/include/ParagraphStyle.h>
+#include <cstddef>
+#include <limits>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace margelo::nitro::RNSkiaYoga {
+
+// One copy of a shaped paragraph laid out at a single width. Painting fills
+// the lines' text blob caches, so paints of a copy go through its mutex.
+struct LaidOutParagraph {
+    std::shared_ptr<RNSkia::JsiSkParagraph> paragraph;
+    float width = 0.0f;
+    std::mutex mutex;
+};
+
+// A built paragraph, shared by every node showing the same text and style.
+// `paragraph` is relaid out by measurement at whatever width Yoga asks for,
+// while nodes paint from per-width copies, so a node never paints a layout
+// another node just replaced.
+struct ShapedParagraph {
+    std::string text;
+    skia::textlayout::ParagraphStyle style;
+    std::shared_ptr<RNSkia::JsiSkParagraph> paragraph;
+    float laidOutWidth = std::numeric_limits<float>::quiet_NaN();
+    // Paragraphs passed in from JS may be laid out by JS as well, so their
+    // last width is never trusted, and without their text they can't be
+    // copied per width.
+    bool memoizesLayout = true;
+    // Guards `paragraph`, `laidOutWidth` and `layouts`.
+    std::mutex mutex;
+    // Recently used widths, most recent last.
+    std::vector<std::shared_ptr<LaidOutParagraph>> layouts;
+};
+
+// Compares every ParagraphStyle field that affects building, shaping or
+// layout. Skia's operator== skips the lines limit, strut style, text height
+// behavior and hinting, so it can't be used to share paragraphs or builders.
+bool sameParagraphStyle(const skia::textlayout::ParagraphStyle& a, const skia::textlayout::ParagraphStyle& b);
+
+// Process-wide LRU of shaped paragraphs keyed by text and paragraph style, so
+// repeated labels such as list-row titles are built and shaped once.
+class ParagraphCache {
+public:
+    static constexpr size_t kDefaultCapacity = 512;
+
+    static ParagraphCache& shared();
+
+    std::shared_ptr<ShapedParagraph> find(const std::string& text, const skia::textlayout::ParagraphStyle& style);
+    void store(const std::string& text, const skia::textlayout::ParagraphStyle& style, std::shared_ptr<ShapedParagraph> paragraph);
+
+    void setCapacity(size_t capacity);
+
+private:
+    struct Entry {
+        size_t hash;
+        std::string text;
+        skia::textlayout::ParagraphStyle style;
+        std::shared_ptr<ShapedParagraph> paragraph;
+    };
+
+    static size_t hashKey(const std::string& text, const skia::textlayout::ParagraphStyle& style);
+    void eraseEntry(std::list<Entry>::iterator entry);
+    void evictToCapacity();
+
+    std::mutex _mutex;
+    std::list<Entry> _entries;
+    std::unordered_multimap<size_t, std::list<Entry>::iterator> _entriesByHash;
+    size_t _capacity = kDefaultCapacity;
+};
+
+} // namespace margelo::nitro::RNSkiaYoga
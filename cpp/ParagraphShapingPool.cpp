@@ -0,0 +1,74 @@
+#include "ParagraphShapingPool.hpp"
+
+#include <utility>
+
+namespace margelo::nitro::RNSkiaYoga {
+
+ParagraphShapingPool& ParagraphShapingPool::shared()
+{
+    static ParagraphShapingPool pool;
+    return pool;
+}
+
+ParagraphShapingPool::ParagraphShapingPool()
+    : _worker([this]() { run(); })
+{
+}
+
+ParagraphShapingPool::~ParagraphShapingPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping = true;
+    }
+    _jobAvailable.notify_all();
+    _worker.join();
+}
+
+void ParagraphShapingPool::submit(std::function<void()> job)
+{
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _jobs.push_back(std::move(job));
+    }
+    _jobAvailable.notify_one();
+}
+
+void ParagraphShapingPool::waitUntilIdle()
+{
+    std::unique_lock<std::mutex> lock(_mutex);
+    _idle.wait(lock, [this]() { return _jobs.empty() && _activeJobs == 0; });
+}
+
+void ParagraphShapingPool::run()
+{
+    while (true) {
+        std::function<void()> job;
+        {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _jobAvailable.wait(lock, [this]() { return _stopping || !_jobs.empty(); });
+            if (_stopping) {
+                return;
+            }
+            job = std::move(_jobs.front());
+            _jobs.pop_front();
+            _activeJobs += 1;
+        }
+
+        // An exception escaping the worker would terminate the process.
+        try {
+            job();
+        } catch (...) {
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _activeJobs -= 1;
+            if (_jobs.empty() && _activeJobs == 0) {
+                _idle.notify_all();
+            }
+        }
+    }
+}
+
+} // namespace margelo::nitro::RNSkiaYoga
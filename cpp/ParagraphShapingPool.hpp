@@ -0,0 +1,47 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+namespace margelo::nitro::RNSkiaYoga {
+
+// Process-wide worker thread that builds and first lays out paragraphs, so
+// committing text does not shape it on the JS thread. Jobs run in submission
+// order. Shaping goes through the one shared font collection and its lock, so
+// more workers would only queue behind each other and keep that lock busy
+// for the JS and render threads.
+class ParagraphShapingPool {
+public:
+    static ParagraphShapingPool& shared();
+
+    ~ParagraphShapingPool();
+
+    ParagraphShapingPool(const ParagraphShapingPool&) = delete;
+    ParagraphShapingPool& operator=(const ParagraphShapingPool&) = delete;
+
+    // Jobs report their own failures; one that throws anyway is dropped.
+    void submit(std::function<void()> job);
+
+    // Blocks until every submitted job has finished. Meant for benchmarks and
+    // offscreen rendering that need the final text layout.
+    void waitUntilIdle();
+
+private:
+    ParagraphShapingPool();
+
+    void run();
+
+    std::mutex _mutex;
+    std::condition_variable _jobAvailable;
+    std::condition_variable _idle;
+    std::deque<std::function<void()>> _jobs;
+    size_t _activeJobs = 0;
+    bool _stopping = false;
+    std::thread _worker;
+};
+
+} // namespace margelo::nitro::RNSkiaYoga
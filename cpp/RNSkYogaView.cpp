@@ -5,18 +5,25 @@
 #include <cmath>
 #include <cstring>
 #include <cstdio>
+#include <optional>
 #include <utility>
 #include <include/core/SkPaint.h>
 #include <include/core/SkColor.h>
 #include <include/core/SkRect.h>
+#include <include/core/SkImageInfo.h>
 
 #include "DrawingCtx.h"
+#include "RasterCacheManager.hpp"
 #include "YogaNode.hpp"
 
 namespace margelo::nitro::RNSkiaYoga {
 
 namespace {
 
+// Above this share of the view, clipping and culling cost more than they save
+// and the frame is repainted in full.
+constexpr double kFullRedrawDamageRatio = 0.5;
+
 constexpr int kDigitWidth = 10;
 constexpr int kDigitHeight = 16;
 constexpr int kDigitThickness = 2;
@@ -85,31 +92,136 @@ RNSkYogaRenderer::RNSkYogaRenderer(
 {
 }
 
+// Cache stats are keyed by this renderer's address, which a later renderer
+// may reuse.
+RNSkYogaRenderer::~RNSkYogaRenderer()
+{
+	RasterCacheManager::shared().forgetView(this);
+}
+
 void RNSkYogaRenderer::renderImmediate(
 	std::shared_ptr<RNSkia::RNSkCanvasProvider> canvasProvider)
 {
 	std::shared_ptr<YogaNode> root;
+	bool hasSnapshot = false;
 	{
 		std::lock_guard<std::mutex> lock(_mutex);
 		root = _root;
+		hasSnapshot = _snapshot != nullptr;
 	}
 
 	const auto pixelDensity =
 		_platformContext != nullptr ? _platformContext->getPixelDensity() : 1.0f;
+	auto debugRoot = getShowDebugOverlays() ? root : nullptr;
+
+	// Static trees replay the snapshot published at the last commit and never
+	// touch the live tree. The live path runs its phases in order: layout once
+	// from the root, animated values in one batch, then this frame's damage,
+	// so drawing never has to run Yoga.
+	const auto prepareLiveTree = [&]() {
+		const auto layoutStart = std::chrono::steady_clock::now();
+		if (root->updateLayout()) {
+			addLayoutDuration(layoutStart);
+		}
+		root->sampleAnimatedValues();
+		return root->collectDamage(SkMatrix::Scale(pixelDensity, pixelDensity));
+	};
+	auto liveDamage = SkRect::MakeEmpty();
+	if (!hasSnapshot && root != nullptr) {
+		liveDamage = prepareLiveTree();
+	}
+
+	// The snapshot and the damage published with it are taken together, so a
+	// commit landing mid-frame never has its damage painted from an older
+	// picture.
+	sk_sp<SkPicture> snapshot;
+	std::shared_ptr<const std::vector<YogaSnapshotCullEntry>> snapshotCullEntries;
+	SkRect damage;
+	bool fullRedraw = false;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		snapshot = _snapshot;
+		snapshotCullEntries = _snapshotCullEntries;
+		damage = _pendingDamage;
+		damage.join(liveDamage);
+		fullRedraw = _fullRedrawPending;
+		_pendingDamage.setEmpty();
+		_fullRedrawPending = false;
+	}
+	if (snapshot != nullptr) {
+		root = nullptr;
+	} else if (hasSnapshot && root != nullptr) {
+		// The snapshot was dropped since the first look; draw the live tree.
+		damage.join(prepareLiveTree());
+	}
 
-	canvasProvider->renderToCanvas([this, root = std::move(root), pixelDensity](
-											SkCanvas* canvas) {
+	canvasProvider->renderToCanvas([this, root = std::move(root), debugRoot = std::move(debugRoot), snapshot = std::move(snapshot), snapshotCullEntries = std::move(snapshotCullEntries), pixelDensity, damage, fullRedraw](
+											SkCanvas* canvas) mutable {
 		auto drawStart = std::chrono::steady_clock::now();
-		canvas->clear(SK_ColorTRANSPARENT);
-		canvas->save();
-		canvas->scale(pixelDensity, pixelDensity);
+		size_t culledNodes = 0;
+
+		// The view is drawn into a retained frame surface that is presented
+		// with a single blit, so a frame only repaints its damaged area.
+		const auto frameSize = canvas->getBaseLayerSize();
+		if (_frameSurface == nullptr ||
+			_frameSurface->width() != frameSize.width() ||
+			_frameSurface->height() != frameSize.height()) {
+			_frameSurface = canvas->makeSurface(
+				SkImageInfo::MakeN32Premul(frameSize.width(), frameSize.height()));
+			fullRedraw = true;
+		}
+
+		auto* frameCanvas = _frameSurface != nullptr ? _frameSurface->getCanvas() : canvas;
+		if (_frameSurface == nullptr) {
+			fullRedraw = true;
+		}
+
+		auto dirtyRect = SkIRect::MakeSize(frameSize);
+		if (!fullRedraw) {
+			if (!dirtyRect.intersect(damage.roundOut())) {
+				dirtyRect.setEmpty();
+			}
+			const auto frameArea = static_cast<double>(frameSize.width()) * frameSize.height();
+			const auto dirtyArea = static_cast<double>(dirtyRect.width()) * dirtyRect.height();
+			fullRedraw = dirtyArea > frameArea * kFullRedrawDamageRatio;
+		}
 
-		if (root != nullptr) {
-			RNSkia::DrawingCtx ctx(canvas);
-			root->renderToContext(ctx);
+		if (fullRedraw || !dirtyRect.isEmpty()) {
+			frameCanvas->save();
+			if (!fullRedraw) {
+				frameCanvas->clipIRect(dirtyRect);
+			}
+			frameCanvas->clear(SK_ColorTRANSPARENT);
+
+			if (snapshot != nullptr) {
+				// Snapshots are recorded with the pixel density already applied.
+				// Their R-tree only replays ops under the dirty rect.
+				frameCanvas->drawPicture(snapshot);
+				if (snapshotCullEntries != nullptr) {
+					const auto clipBounds = SkRect::Make(fullRedraw ? SkIRect::MakeSize(frameSize) : dirtyRect);
+					for (const auto& entry : *snapshotCullEntries) {
+						if (!SkRect::Intersects(entry.bounds, clipBounds)) {
+							culledNodes += entry.nodeCount;
+						}
+					}
+				}
+			} else if (root != nullptr) {
+				frameCanvas->scale(pixelDensity, pixelDensity);
+				RasterCacheViewScope rasterCacheScope(this);
+				RNSkia::DrawingCtx ctx(frameCanvas);
+				// The dirty-rect clip above also drives offscreen subtree culling.
+				YogaNode::consumeCulledNodeCount();
+				root->renderToContext(ctx);
+				culledNodes = YogaNode::consumeCulledNodeCount();
+			}
+
+			frameCanvas->restore();
 		}
 
-		canvas->restore();
+		if (_frameSurface != nullptr) {
+			canvas->clear(SK_ColorTRANSPARENT);
+			canvas->drawImage(_frameSurface->makeImageSnapshot(), 0.0f, 0.0f);
+		}
 
 		if (getShowDebugOverlays()) {
 			double fps = 0.0;
@@ -121,6 +233,12 @@ void RNSkYogaRenderer::renderImmediate(
 			canvas->save();
 			canvas->scale(pixelDensity, pixelDensity);
 
+			// Node bounds go on the presented canvas, outside the retained
+			// frame, so toggling the overlay never touches the tree's caches.
+			if (debugRoot != nullptr) {
+				debugRoot->drawDebugOverlay(canvas);
+			}
+
 			SkPaint badgePaint;
 			badgePaint.setColor(SkColorSetARGB(185, 8, 19, 29));
 			badgePaint.setStyle(SkPaint::kFill_Style);
@@ -220,13 +338,68 @@ void RNSkYogaRenderer::renderImmediate(
 							 .count();
 		std::lock_guard<std::mutex> lock(_drawTimingMutex);
 		_lastDrawDurationMs = drawMs;
+		_culledNodes += static_cast<double>(culledNodes);
 	});
 }
 
-void RNSkYogaRenderer::setRoot(const std::shared_ptr<YogaNode>& root)
+// Returns the root that was shown before.
+std::shared_ptr<YogaNode> RNSkYogaRenderer::setRoot(const std::shared_ptr<YogaNode>& root)
+{
+	std::lock_guard<std::mutex> lock(_mutex);
+	auto previousRoot = std::exchange(_root, root);
+	_snapshot.reset();
+	_snapshotCullEntries.reset();
+	_fullRedrawPending = true;
+	return previousRoot;
+}
+
+void RNSkYogaRenderer::addDamage(const SkRect& damage)
 {
 	std::lock_guard<std::mutex> lock(_mutex);
-	_root = root;
+	_pendingDamage.join(damage);
+}
+
+// Called at commit boundaries on the JS thread. The snapshot is recorded under
+// the tree lock and swapped in under the short renderer mutex, so the render
+// thread never waits on reconciliation for static trees.
+void RNSkYogaRenderer::publishSnapshot()
+{
+	std::shared_ptr<YogaNode> root;
+	{
+		std::lock_guard<std::mutex> lock(_mutex);
+		root = _root;
+	}
+
+	const auto pixelDensity =
+		_platformContext != nullptr ? _platformContext->getPixelDensity() : 1.0f;
+
+	sk_sp<SkPicture> snapshot;
+	auto snapshotCullEntries = std::make_shared<std::vector<YogaSnapshotCullEntry>>();
+	auto damage = SkRect::MakeEmpty();
+	if (root != nullptr) {
+		RasterCacheViewScope rasterCacheScope(this);
+		try {
+			const auto layoutStart = std::chrono::steady_clock::now();
+			if (root->updateLayout()) {
+				addCommitLayoutDuration(layoutStart);
+			}
+			// Damage is taken before recording so it reflects this commit.
+			damage = root->collectDamage(SkMatrix::Scale(pixelDensity, pixelDensity));
+			snapshot = root->recordSnapshot(pixelDensity, *snapshotCullEntries);
+		} catch (...) {
+			snapshot.reset();
+			damage = SkRect::MakeEmpty();
+			std::lock_guard<std::mutex> lock(_mutex);
+			_fullRedrawPending = true;
+		}
+	}
+
+	std::lock_guard<std::mutex> lock(_mutex);
+	if (_root == root) {
+		_snapshot = std::move(snapshot);
+		_snapshotCullEntries = std::move(snapshotCullEntries);
+		_pendingDamage.join(damage);
+	}
 }
 
 double RNSkYogaRenderer::consumeLastDrawDurationMs()
@@ -235,6 +408,46 @@ double RNSkYogaRenderer::consumeLastDrawDurationMs()
 	return std::exchange(_lastDrawDurationMs, 0.0);
 }
 
+// Layout that ran on the render thread while drawing a live tree. It is part
+// of the frame time, so onFrame subtracts it from present time.
+void RNSkYogaRenderer::addLayoutDuration(std::chrono::steady_clock::time_point layoutStart)
+{
+	const auto layoutMs = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - layoutStart)
+							  .count();
+	std::lock_guard<std::mutex> lock(_drawTimingMutex);
+	_layoutDurationMs += layoutMs;
+}
+
+// Layout that ran on the JS thread while publishing a snapshot. It is summed
+// until the next frame reads it and reported on its own.
+void RNSkYogaRenderer::addCommitLayoutDuration(std::chrono::steady_clock::time_point layoutStart)
+{
+	const auto layoutMs = std::chrono::duration<double, std::milli>(
+		std::chrono::steady_clock::now() - layoutStart)
+							  .count();
+	std::lock_guard<std::mutex> lock(_drawTimingMutex);
+	_commitLayoutDurationMs += layoutMs;
+}
+
+double RNSkYogaRenderer::consumeLayoutDurationMs()
+{
+	std::lock_guard<std::mutex> lock(_drawTimingMutex);
+	return std::exchange(_layoutDurationMs, 0.0);
+}
+
+double RNSkYogaRenderer::consumeCommitLayoutDurationMs()
+{
+	std::lock_guard<std::mutex> lock(_drawTimingMutex);
+	return std::exchange(_commitLayoutDurationMs, 0.0);
+}
+
+double RNSkYogaRenderer::consumeCulledNodes()
+{
+	std::lock_guard<std::mutex> lock(_drawTimingMutex);
+	return std::exchange(_culledNodes, 0.0);
+}
+
 void RNSkYogaRenderer::setDebugFps(double fps)
 {
 	std::lock_guard<std::mutex> lock(_fpsMutex);
@@ -253,8 +466,11 @@ RNSkYogaView::RNSkYogaView(
 {
 }
 
+// Called on the JS thread at commit boundaries.
 void RNSkYogaView::requestRender()
 {
+	std::static_pointer_cast<RNSkYogaRenderer>(getRenderer())->publishSnapshot();
+
 	std::function<void()> callback;
 	{
 		std::lock_guard<std::mutex> lock(_stateMutex);
@@ -289,7 +505,10 @@ void RNSkYogaView::setAnimating(bool animating)
 
 void RNSkYogaView::setRoot(const std::shared_ptr<YogaNode>& root)
 {
-	std::static_pointer_cast<RNSkYogaRenderer>(getRenderer())->setRoot(root);
+	auto previousRoot = std::static_pointer_cast<RNSkYogaRenderer>(getRenderer())->setRoot(root);
+	if (previousRoot != nullptr && previousRoot != root) {
+		previousRoot->setRenderRequestCallback(nullptr);
+	}
 	requestRender();
 }
 
@@ -346,6 +565,8 @@ bool RNSkYogaView::onFrame()
 	auto frameEnd = std::chrono::steady_clock::now();
 
 	auto drawMs = renderer->consumeLastDrawDurationMs();
+	const auto layoutMs = std::max(0.0, renderer->consumeLayoutDurationMs());
+	const auto commitLayoutMs = std::max(0.0, renderer->consumeCommitLayoutDurationMs());
 	const auto frameMs = std::chrono::duration<double, std::milli>(
 		frameEnd - frameStart)
 						 .count();
@@ -355,8 +576,8 @@ bool RNSkYogaView::onFrame()
 	if (drawMs > frameMs) {
 		drawMs = frameMs;
 	}
-	const auto presentMs = std::max(0.0, frameMs - drawMs);
-	recordFrameMetrics(drawMs, presentMs);
+	const auto presentMs = std::max(0.0, frameMs - drawMs - layoutMs);
+	recordFrameMetrics(layoutMs, commitLayoutMs, drawMs, presentMs);
 
 	std::function<void()> stopCallback;
 	bool shouldContinue = false;
@@ -376,7 +597,7 @@ bool RNSkYogaView::onFrame()
 	return shouldContinue;
 }
 
-void RNSkYogaView::recordFrameMetrics(double drawMs, double presentMs)
+void RNSkYogaView::recordFrameMetrics(double layoutMs, double commitLayoutMs, double drawMs, double presentMs)
 {
 	std::lock_guard<std::mutex> lock(_profilingMutex);
 	const auto now = std::chrono::steady_clock::now();
@@ -386,10 +607,14 @@ void RNSkYogaView::recordFrameMetrics(double drawMs, double presentMs)
 	}
 
 	_profilingFrames += 1.0;
+	_profilingLayoutTotalMs += layoutMs;
 	_profilingDrawTotalMs += drawMs;
 	_profilingPresentTotalMs += presentMs;
+	_profilingCommitLayoutTotalMs += commitLayoutMs;
+	_profilingMaxLayoutMs = std::max(_profilingMaxLayoutMs, layoutMs);
 	_profilingMaxDrawMs = std::max(_profilingMaxDrawMs, drawMs);
 	_profilingMaxPresentMs = std::max(_profilingMaxPresentMs, presentMs);
+	_profilingMaxCommitLayoutMs = std::max(_profilingMaxCommitLayoutMs, commitLayoutMs);
 }
 
 RNSkYogaProfilingSample RNSkYogaView::consumeProfilingSample()
@@ -406,17 +631,33 @@ RNSkYogaProfilingSample RNSkYogaView::consumeProfilingSample()
 
 	sample.frames = _profilingFrames;
 	if (_profilingFrames > 0.0) {
+		sample.avgLayoutMs = _profilingLayoutTotalMs / _profilingFrames;
 		sample.avgDrawMs = _profilingDrawTotalMs / _profilingFrames;
 		sample.avgPresentMs = _profilingPresentTotalMs / _profilingFrames;
+		sample.avgCommitLayoutMs = _profilingCommitLayoutTotalMs / _profilingFrames;
+		sample.maxLayoutMs = _profilingMaxLayoutMs;
 		sample.maxDrawMs = _profilingMaxDrawMs;
 		sample.maxPresentMs = _profilingMaxPresentMs;
+		sample.maxCommitLayoutMs = _profilingMaxCommitLayoutMs;
 	}
 
+	const auto renderer = std::static_pointer_cast<RNSkYogaRenderer>(getRenderer());
+	const auto rasterCacheStats = RasterCacheManager::shared().consumeStats(renderer.get());
+	sample.rasterCacheHits = static_cast<double>(rasterCacheStats.hits);
+	sample.rasterCacheMisses = static_cast<double>(rasterCacheStats.misses);
+	sample.rasterCacheEvictions = static_cast<double>(rasterCacheStats.evictions);
+	sample.rasterCacheBytes = static_cast<double>(rasterCacheStats.bytes);
+	sample.culledNodes = renderer->consumeCulledNodes();
+
 	_profilingSampleActive = false;
+	_profilingLayoutTotalMs = 0.0;
 	_profilingDrawTotalMs = 0.0;
 	_profilingPresentTotalMs = 0.0;
+	_profilingCommitLayoutTotalMs = 0.0;
+	_profilingMaxLayoutMs = 0.0;
 	_profilingMaxDrawMs = 0.0;
 	_profilingMaxPresentMs = 0.0;
+	_profilingMaxCommitLayoutMs = 0.0;
 	_profilingFrames = 0.0;
 
 	return sample;
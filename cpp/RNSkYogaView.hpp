@@ -5,8 +5,12 @@
 #include <memory>
 #include <mutex>
 #include <unordered_map>
+#include <vector>
 
 #include "RNSkView.h"
+#include <include/core/SkPicture.h>
+#include <include/core/SkRect.h>
+#include <include/core/SkSurface.h>
 
 namespace RNSkia {
 class DrawingCtx;
@@ -15,14 +19,24 @@ class DrawingCtx;
 namespace margelo::nitro::RNSkiaYoga {
 
 class YogaNode;
+struct YogaSnapshotCullEntry;
 
 struct RNSkYogaProfilingSample {
+	double avgLayoutMs = 0.0;
 	double avgDrawMs = 0.0;
 	double avgPresentMs = 0.0;
+	double avgCommitLayoutMs = 0.0;
+	double maxLayoutMs = 0.0;
 	double maxDrawMs = 0.0;
 	double maxPresentMs = 0.0;
+	double maxCommitLayoutMs = 0.0;
 	double sampleDurationMs = 0.0;
 	double frames = 0.0;
+	double rasterCacheHits = 0.0;
+	double rasterCacheMisses = 0.0;
+	double rasterCacheEvictions = 0.0;
+	double rasterCacheBytes = 0.0;
+	double culledNodes = 0.0;
 };
 
 class RNSkYogaRenderer final : public RNSkia::RNSkRenderer {
@@ -30,23 +44,40 @@ public:
 	RNSkYogaRenderer(
 		std::function<void()> requestRedraw,
 		std::shared_ptr<RNSkia::RNSkPlatformContext> context);
+	~RNSkYogaRenderer() override;
 
 	void renderImmediate(
 		std::shared_ptr<RNSkia::RNSkCanvasProvider> canvasProvider
 	) override;
 
-	void setRoot(const std::shared_ptr<YogaNode>& root);
+	std::shared_ptr<YogaNode> setRoot(const std::shared_ptr<YogaNode>& root);
+	void publishSnapshot();
+	void addDamage(const SkRect& damage);
 	double consumeLastDrawDurationMs();
+	double consumeLayoutDurationMs();
+	double consumeCommitLayoutDurationMs();
+	double consumeCulledNodes();
 	void setDebugFps(double fps);
 
 private:
+	void addLayoutDuration(std::chrono::steady_clock::time_point layoutStart);
+	void addCommitLayoutDuration(std::chrono::steady_clock::time_point layoutStart);
+
 	std::mutex _mutex;
 	std::mutex _drawTimingMutex;
 	std::mutex _fpsMutex;
 	double _lastDrawDurationMs = 0.0;
+	double _layoutDurationMs = 0.0;
+	double _commitLayoutDurationMs = 0.0;
+	double _culledNodes = 0.0;
 	double _debugFps = 0.0;
 	std::shared_ptr<RNSkia::RNSkPlatformContext> _platformContext;
 	std::shared_ptr<YogaNode> _root;
+	sk_sp<SkPicture> _snapshot;
+	std::shared_ptr<const std::vector<YogaSnapshotCullEntry>> _snapshotCullEntries;
+	SkRect _pendingDamage = SkRect::MakeEmpty();
+	bool _fullRedrawPending = true;
+	sk_sp<SkSurface> _frameSurface;
 };
 
 class RNSkYogaView : public RNSkia::RNSkView {
@@ -69,7 +100,7 @@ public:
 	bool onFrame();
 
 private:
-	void recordFrameMetrics(double drawMs, double presentMs);
+	void recordFrameMetrics(double layoutMs, double commitLayoutMs, double drawMs, double presentMs);
 
 	std::mutex _stateMutex;
 	std::mutex _profilingMutex;
@@ -77,10 +108,14 @@ private:
 	bool _dirty = true;
 	bool _schedulerRunning = false;
 	bool _profilingSampleActive = false;
+	double _profilingLayoutTotalMs = 0.0;
 	double _profilingDrawTotalMs = 0.0;
 	double _profilingPresentTotalMs = 0.0;
+	double _profilingCommitLayoutTotalMs = 0.0;
+	double _profilingMaxLayoutMs = 0.0;
 	double _profilingMaxDrawMs = 0.0;
 	double _profilingMaxPresentMs = 0.0;
+	double _profilingMaxCommitLayoutMs = 0.0;
 	double _profilingFrames = 0.0;
 	double _smoothedFps = 0.0;
 	bool _hasPreviousFrameStart = false;
@@ -0,0 +1,166 @@
+#include "RasterCacheManager.hpp"
+
+#include <iterator>
+#include <utility>
+
+namespace margelo::nitro::RNSkiaYoga {
+
+namespace {
+
+thread_local const void* sCurrentView = nullptr;
+
+// Null when no view is drawing, so the caller skips accounting.
+RasterCacheStats* statsFor(std::unordered_map<const void*, RasterCacheStats>& statsByView, const void* view)
+{
+    return view != nullptr ? &statsByView[view] : nullptr;
+}
+
+} // namespace
+
+RasterCacheManager& RasterCacheManager::shared()
+{
+    static RasterCacheManager manager;
+    return manager;
+}
+
+sk_sp<SkImage> RasterCacheManager::find(const void* owner, int width, int height, float scale)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto* stats = statsFor(_statsByView, RasterCacheViewScope::current());
+
+    const auto found = _entriesByOwner.find(owner);
+    if (found == _entriesByOwner.end() ||
+        found->second->width != width ||
+        found->second->height != height ||
+        found->second->scale < scale * kMinScaleRatio ||
+        found->second->scale > scale * kMaxScaleRatio) {
+        if (stats != nullptr) {
+            stats->misses += 1;
+        }
+        return nullptr;
+    }
+
+    if (stats != nullptr) {
+        stats->hits += 1;
+    }
+    _entries.splice(_entries.begin(), _entries, found->second);
+    return found->second->image;
+}
+
+void RasterCacheManager::store(const void* owner, sk_sp<SkImage> image, int width, int height, float scale)
+{
+    if (image == nullptr) {
+        erase(owner);
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (const auto found = _entriesByOwner.find(owner); found != _entriesByOwner.end()) {
+        eraseEntry(found->second);
+    }
+
+    const auto bytes = image->imageInfo().computeMinByteSize();
+    // An image that alone exceeds the budget would evict everything else and
+    // then itself, so it is simply not kept.
+    if (bytes > _budgetBytes) {
+        return;
+    }
+
+    const auto* view = RasterCacheViewScope::current();
+    _entries.push_front(Entry { owner, view, std::move(image), width, height, scale, bytes });
+    _entriesByOwner[owner] = _entries.begin();
+    _bytes += bytes;
+    if (auto* stats = statsFor(_statsByView, view)) {
+        stats->bytes += bytes;
+    }
+    evictToBudget();
+}
+
+void RasterCacheManager::erase(const void* owner)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (const auto found = _entriesByOwner.find(owner); found != _entriesByOwner.end()) {
+        eraseEntry(found->second);
+    }
+}
+
+void RasterCacheManager::setBudgetBytes(size_t budgetBytes)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _budgetBytes = budgetBytes;
+    evictToBudget();
+}
+
+size_t RasterCacheManager::budgetBytes() const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _budgetBytes;
+}
+
+RasterCacheStats RasterCacheManager::consumeStats(const void* view)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    const auto found = _statsByView.find(view);
+    if (found == _statsByView.end()) {
+        return {};
+    }
+
+    auto stats = found->second;
+    found->second.hits = 0;
+    found->second.misses = 0;
+    found->second.evictions = 0;
+    if (found->second.bytes == 0) {
+        _statsByView.erase(found);
+    }
+    return stats;
+}
+
+void RasterCacheManager::forgetView(const void* view)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _statsByView.erase(view);
+    for (auto& entry : _entries) {
+        if (entry.view == view) {
+            entry.view = nullptr;
+        }
+    }
+}
+
+void RasterCacheManager::eraseEntry(std::list<Entry>::iterator entry)
+{
+    _bytes -= entry->bytes;
+    if (const auto stats = _statsByView.find(entry->view); stats != _statsByView.end()) {
+        stats->second.bytes -= entry->bytes;
+    }
+    _entriesByOwner.erase(entry->owner);
+    _entries.erase(entry);
+}
+
+void RasterCacheManager::evictToBudget()
+{
+    while (_bytes > _budgetBytes && !_entries.empty()) {
+        auto victim = std::prev(_entries.end());
+        if (auto* stats = statsFor(_statsByView, victim->view)) {
+            stats->evictions += 1;
+        }
+        eraseEntry(victim);
+    }
+}
+
+RasterCacheViewScope::RasterCacheViewScope(const void* view)
+    : _previousView(sCurrentView)
+{
+    sCurrentView = view;
+}
+
+RasterCacheViewScope::~RasterCacheViewScope()
+{
+    sCurrentView = _previousView;
+}
+
+const void* RasterCacheViewScope::current()
+{
+    return sCurrentView;
+}
+
+} // namespace margelo::nitro::RNSkiaYoga
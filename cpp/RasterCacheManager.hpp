@@ -0,0 +1,90 @@
+#pragma once
+
+#include <include/core/SkImage.h>
+#include <include/core/SkRefCnt.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace margelo::nitro::RNSkiaYoga {
+
+struct RasterCacheStats {
+    uint64_t hits = 0;
+    uint64_t misses = 0;
+    uint64_t evictions = 0;
+    size_t bytes = 0;
+};
+
+// Process-wide store for the images of rasterized groups. Entries are keyed by
+// the owning node and evicted least-recently-used once the byte budget is
+// exceeded. Hits, misses, evictions and resident bytes are accounted to the
+// view that is currently drawing on this thread (see RasterCacheViewScope);
+// traffic outside of any view is not counted.
+//
+// Images are rasterized at a device scale. A lookup reuses one whose scale is
+// within kMinScaleRatio..kMaxScaleRatio of the requested scale, so small zoom
+// or density changes keep the image while a visibly blurry or needlessly large
+// one is re-rasterized.
+class RasterCacheManager {
+public:
+    static constexpr size_t kDefaultBudgetBytes = 64 * 1024 * 1024;
+    static constexpr float kMinScaleRatio = 0.9f;
+    static constexpr float kMaxScaleRatio = 2.0f;
+
+    static RasterCacheManager& shared();
+
+    sk_sp<SkImage> find(const void* owner, int width, int height, float scale);
+    void store(const void* owner, sk_sp<SkImage> image, int width, int height, float scale);
+    void erase(const void* owner);
+
+    void setBudgetBytes(size_t budgetBytes);
+    size_t budgetBytes() const;
+
+    // Returns the counters accumulated for a view since the last call and its
+    // current resident bytes.
+    RasterCacheStats consumeStats(const void* view);
+    // Drops a view's counters when it goes away. Its images stay cached but
+    // are no longer accounted to any view.
+    void forgetView(const void* view);
+
+private:
+    struct Entry {
+        const void* owner;
+        const void* view;
+        sk_sp<SkImage> image;
+        int width;
+        int height;
+        float scale;
+        size_t bytes;
+    };
+
+    void eraseEntry(std::list<Entry>::iterator entry);
+    void evictToBudget();
+
+    mutable std::mutex _mutex;
+    std::list<Entry> _entries;
+    std::unordered_map<const void*, std::list<Entry>::iterator> _entriesByOwner;
+    std::unordered_map<const void*, RasterCacheStats> _statsByView;
+    size_t _bytes = 0;
+    size_t _budgetBytes = kDefaultBudgetBytes;
+};
+
+// Marks the view whose frame is being drawn on the current thread, so cache
+// traffic caused by its tree is attributed to it.
+class RasterCacheViewScope {
+public:
+    explicit RasterCacheViewScope(const void* view);
+    ~RasterCacheViewScope();
+
+    RasterCacheViewScope(const RasterCacheViewScope&) = delete;
+    RasterCacheViewScope& operator=(const RasterCacheViewScope&) = delete;
+
+    static const void* current();
+
+private:
+    const void* _previousView;
+};
+
+} // namespace margelo::nitro::RNSkiaYoga
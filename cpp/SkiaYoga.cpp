@@ -2,7 +2,9 @@
 #include "JsiPromises.h"
 #include "RNSkJsiViewApi.h"
 #include "RNSkYogaView.hpp"
+#include "RuntimeAwareCache.h"
 #include "YogaNode.hpp"
+#include <NitroModules/Dispatcher.hpp>
 #include <jsi/jsi.h>
 #include <sstream>
 #include <yoga/Yoga.h>
@@ -50,11 +52,20 @@ std::string serializeProfileSample(const RNSkYogaProfilingSample& sample)
 {
     std::ostringstream stream;
     stream << "{";
+    stream << "\"avgCommitLayoutMs\":" << sample.avgCommitLayoutMs << ",";
     stream << "\"avgDrawMs\":" << sample.avgDrawMs << ",";
+    stream << "\"avgLayoutMs\":" << sample.avgLayoutMs << ",";
     stream << "\"avgPresentMs\":" << sample.avgPresentMs << ",";
+    stream << "\"culledNodes\":" << sample.culledNodes << ",";
     stream << "\"frames\":" << sample.frames << ",";
+    stream << "\"maxCommitLayoutMs\":" << sample.maxCommitLayoutMs << ",";
     stream << "\"maxDrawMs\":" << sample.maxDrawMs << ",";
+    stream << "\"maxLayoutMs\":" << sample.maxLayoutMs << ",";
     stream << "\"maxPresentMs\":" << sample.maxPresentMs << ",";
+    stream << "\"rasterCacheBytes\":" << sample.rasterCacheBytes << ",";
+    stream << "\"rasterCacheEvictions\":" << sample.rasterCacheEvictions << ",";
+    stream << "\"rasterCacheHits\":" << sample.rasterCacheHits << ",";
+    stream << "\"rasterCacheMisses\":" << sample.rasterCacheMisses << ",";
     stream << "\"sampleDurationMs\":" << sample.sampleDurationMs;
     stream << "}";
     return stream.str();
@@ -70,7 +81,36 @@ void SkiaYoga::attachViewRoot(
     if (view == nullptr) {
         return;
     }
-    view->setRoot(getYogaNode(root));
+    auto node = getYogaNode(root);
+    if (node != nullptr) {
+        // Paragraphs shaped in the background land after the commit that
+        // created them and need a frame of their own. The request comes from
+        // a shaping worker, so the snapshot is republished on the JS thread,
+        // between commits, rather than on the worker mid-commit.
+        std::weak_ptr<Dispatcher> weakDispatcher;
+        if (auto* runtime = RNJsi::BaseRuntimeAwareCache::getMainJsRuntime()) {
+            try {
+                weakDispatcher = Dispatcher::getRuntimeGlobalDispatcher(*runtime);
+            } catch (...) {
+                // No dispatcher: ParagraphCmd shapes inline then, so no
+                // background result needs republishing.
+            }
+        }
+        std::weak_ptr<RNSkYogaView> weakView = view;
+        node->setRenderRequestCallback([weakDispatcher, weakView]() {
+            // Only a dispatcher torn down with its runtime is missing here.
+            auto dispatcher = weakDispatcher.lock();
+            if (dispatcher == nullptr) {
+                return;
+            }
+            dispatcher->runAsync([weakView]() {
+                if (auto view = weakView.lock()) {
+                    view->requestRender();
+                }
+            });
+        });
+    }
+    view->setRoot(node);
 }
 
 void SkiaYoga::detachViewRoot(double nativeId)
@@ -5,6 +5,7 @@
 #include <include/core/SkColor.h>
 #include "SkiaYoga.hpp"
 #include <array>
+#include <atomic>
 #include <cmath>
 #include <functional>
 #include <jsi/jsi.h>
@@ -18,12 +19,16 @@
 #include "JsiSkHostObjects.h"
 #include "JsiSkMatrix.h"
 #include "JsiSkTextStyle.h"
+#include <include/core/SkBBHFactory.h>
 #include <include/core/SkPictureRecorder.h>
 #include <include/core/SkSurface.h>
 #include "DrawingCtx.h"
 #include "RNSkManager.h"
 #include "RuntimeAwareCache.h"
+#include "ParagraphShapingPool.hpp"
+#include <NitroModules/Dispatcher.hpp>
 #include "PlatformContextAccessor.hpp"
+#include "RasterCacheManager.hpp"
 #include <modules/skparagraph/include/FontCollection.h>
 #include <modules/skparagraph/include/ParagraphBuilder.h>
 #include <modules/skparagraph/include/ParagraphStyle.h>
@@ -36,8 +41,10 @@
 #include <variant>
 #include <yoga/Yoga.h>
 #include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 #include <string_view>
+#include <utility>
 
 namespace margelo::nitro::RNSkiaYoga {
 
@@ -45,12 +52,6 @@ using namespace facebook;
 
 namespace {
 
-std::recursive_mutex& yogaTreeMutex()
-{
-    static std::recursive_mutex mutex;
-    return mutex;
-}
-
 template <typename Fn>
 jsi::Value withJsiError(jsi::Runtime& runtime, const char* name, Fn&& fn)
 {
@@ -110,6 +111,21 @@ std::shared_ptr<SkMatrix> makeMatrixPointer(const MatrixStyleValue& matrixValue)
         matrixValue);
 }
 
+// A JsiSkMatrix is shared with JS and can be mutated in place, so style diffs
+// compare against a copy of its value rather than the pointer.
+template <typename MatrixStyleValue>
+std::optional<SkMatrix> styleMatrixValue(const std::optional<MatrixStyleValue>& matrixValue)
+{
+    if (!matrixValue.has_value()) {
+        return std::nullopt;
+    }
+    const auto matrix = makeMatrixPointer(*matrixValue);
+    if (matrix == nullptr) {
+        return std::nullopt;
+    }
+    return *matrix;
+}
+
 YGNodeRef defaultYogaStyleNode()
 {
     static YGNodeRef defaultNode = YGNodeNew();
@@ -172,7 +188,12 @@ size_t eraseChildReferences(YogaNode& parent, const std::shared_ptr<YogaNode>& c
     return oldSize - parent._children.size();
 }
 
-size_t detachChildFromParent(YogaNode& parent, const std::shared_ptr<YogaNode>& child)
+// The detached subtree moves to nextTreeMutex once it is no longer touched, so
+// other threads can only start working on it after the detach is complete.
+size_t detachChildFromParent(
+    YogaNode& parent,
+    const std::shared_ptr<YogaNode>& child,
+    const std::shared_ptr<std::recursive_mutex>& nextTreeMutex)
 {
     if (!child) {
         return 0;
@@ -198,7 +219,10 @@ size_t detachChildFromParent(YogaNode& parent, const std::shared_ptr<YogaNode>&
         const auto removedInteractiveDescendants = child->_interactiveDescendantCount * static_cast<int>(removedCount);
         parent.adjustInteractiveDescendantCount(-removedInteractiveDescendants);
     }
+    parent.invalidateAnimatedCells();
     parent.invalidateLayout();
+    parent.markHitTestIndexDirty();
+    child->adoptTreeMutex(nextTreeMutex);
     return removedCount;
 }
 
@@ -225,11 +249,79 @@ void detachAllChildren(YogaNode& parent, bool propagateInvalidation)
         YGNodeRemoveAllChildren(parent._node);
     }
 
+    for (const auto& child : parent._children) {
+        if (child) {
+            child->adoptTreeMutex(std::make_shared<std::recursive_mutex>());
+        }
+    }
     parent._children.clear();
 
     if (propagateInvalidation) {
         parent.adjustInteractiveDescendantCount(-removedInteractiveDescendants);
+        parent.invalidateAnimatedCells();
         parent.invalidateLayout();
+        parent.markHitTestIndexDirty();
+    }
+}
+
+const SkRect kPictureRecordingBounds = SkRect::MakeWH(2'000'000, 2'000'000);
+
+constexpr float kMinRasterCacheScale = 1.0f / 16.0f;
+constexpr float kMaxRasterCacheScale = 8.0f;
+
+// Device pixels per local unit for a rasterized group, taken from the largest
+// axis scale of the canvas matrix. Perspective falls back to 1.
+float rasterCacheScale(const SkMatrix& matrix)
+{
+    const auto scale = matrix.getMaxScale();
+    if (!(scale > 0.0f) || !std::isfinite(scale)) {
+        return 1.0f;
+    }
+    return std::clamp(scale, kMinRasterCacheScale, kMaxRasterCacheScale);
+}
+// Nodes skipped by clip culling on this thread since the last
+// YogaNode::consumeCulledNodeCount().
+thread_local size_t sCulledNodeCount = 0;
+
+// Set while recordSnapshot draws on this thread. Rasterized groups then record
+// their children instead of their cached image, since a snapshot holding the
+// image keeps it alive after the raster cache evicts it, outside its budget.
+thread_local bool sRecordingSnapshot = false;
+
+// Identifies each display-list compile across all roots, so a node never
+// mistakes its ops in one list for ops in another.
+std::atomic<uint64_t> sDisplayListGeneration { 0 };
+
+// Stands in for device bounds that cannot be computed; large enough to cover
+// any view while staying well inside float precision.
+const SkRect kUnboundedDeviceRect = SkRect::MakeLTRB(-1e9f, -1e9f, 1e9f, 1e9f);
+// Subtree pictures are replayed at their parent's origin, so content may sit on
+// either side of it once transforms are applied. Used when the subtree has no
+// cull bounds.
+const SkRect kSubtreePictureBounds = SkRect::MakeLTRB(-1'000'000, -1'000'000, 1'000'000, 1'000'000);
+// Larger static subtrees stay flattened so their children keep their own ops,
+// cull bounds and pictures, and a change to one row re-records only that row.
+constexpr size_t kMaxSubtreePictureNodes = 64;
+
+// Roots with fewer interactive nodes keep walking the tree; the index only
+// pays off once the walk visits many candidates.
+constexpr int kHitTestIndexMinNodes = 16;
+constexpr int kHitTestGridMaxCells = 64;
+
+// Background results are republished on the JS thread through the runtime's
+// dispatcher (see SkiaYoga::attachViewRoot). Without one a result would stay
+// hidden until an unrelated commit, so paragraphs are shaped inline instead.
+// Called on the JS thread.
+bool canShapeInBackground()
+{
+    auto* runtime = RNJsi::BaseRuntimeAwareCache::getMainJsRuntime();
+    if (runtime == nullptr) {
+        return false;
+    }
+    try {
+        return Dispatcher::getRuntimeGlobalDispatcher(*runtime) != nullptr;
+    } catch (...) {
+        return false;
     }
 }
 
@@ -245,10 +337,10 @@ sk_sp<SkUnicode> makeUnicode()
 } // namespace
 
 std::optional<SkFont> TextCmd::sDefaultFont;
-std::mutex ParagraphCmd::sParagraphBuilderMutex;
-std::unique_ptr<para::ParagraphBuilder> ParagraphCmd::sDefaultParagraphBuilder;
+std::mutex ParagraphCmd::sParagraphMutex;
 sk_sp<para::FontCollection> ParagraphCmd::sDefaultFontCollection;
-std::optional<para::ParagraphStyle> ParagraphCmd::sDefaultParagraphStyle;
+sk_sp<SkUnicode> ParagraphCmd::sDefaultUnicode;
+std::vector<std::pair<para::ParagraphStyle, std::unique_ptr<para::ParagraphBuilder>>> ParagraphCmd::sParagraphBuilderPool;
 
 namespace {
 
@@ -359,9 +451,57 @@ PointerEventsMode parsePointerEventsMode(const std::string& value)
 
 } // namespace
 
+YogaTreeLock::YogaTreeLock(const YogaNode& node)
+{
+    while (true) {
+        auto mutex = node.treeMutex();
+        mutex->lock();
+        if (node.treeMutex() == mutex) {
+            _mutex = std::move(mutex);
+            return;
+        }
+        mutex->unlock();
+    }
+}
+
+YogaTreeLock::YogaTreeLock(const YogaNode& first, const YogaNode& second)
+{
+    while (true) {
+        auto firstMutex = first.treeMutex();
+        auto secondMutex = second.treeMutex();
+        if (firstMutex == secondMutex) {
+            firstMutex->lock();
+            if (first.treeMutex() == firstMutex && second.treeMutex() == firstMutex) {
+                _mutex = std::move(firstMutex);
+                return;
+            }
+            firstMutex->unlock();
+            continue;
+        }
+
+        std::lock(*firstMutex, *secondMutex);
+        if (first.treeMutex() == firstMutex && second.treeMutex() == secondMutex) {
+            _mutex = std::move(firstMutex);
+            _secondMutex = std::move(secondMutex);
+            return;
+        }
+        firstMutex->unlock();
+        secondMutex->unlock();
+    }
+}
+
+YogaTreeLock::~YogaTreeLock()
+{
+    if (_secondMutex) {
+        _secondMutex->unlock();
+    }
+    _mutex->unlock();
+}
+
 YogaNode::~YogaNode()
 {
-    std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
+    YogaTreeLock lock(*this);
+    RasterCacheManager::shared().erase(this);
     detachAllChildren(*this, false);
     if (_node != nullptr) {
         YGNodeFree(_node);
@@ -937,367 +1077,571 @@ static void setYGWidthValue(YGNodeRef node, const std::variant<std::string, doub
         YGNodeStyleSetWidthAuto, node, value, "width", true);
 }
 
+static bool sameStyleValue(const SkPoint& a, const SkPoint& b)
+{
+    return a.x == b.x && a.y == b.y;
+}
+
+// SkPaint has no reliable equality; treat paint-valued props as always changed.
+static bool sameStyleValue(const SkPaint&, const SkPaint&)
+{
+    return false;
+}
+
+static bool sameStyleValue(const TransformRotateX& a, const TransformRotateX& b) { return a.rotateX == b.rotateX; }
+static bool sameStyleValue(const TransformRotateY& a, const TransformRotateY& b) { return a.rotateY == b.rotateY; }
+static bool sameStyleValue(const TransformRotateZ& a, const TransformRotateZ& b) { return a.rotateZ == b.rotateZ; }
+static bool sameStyleValue(const TransformScale& a, const TransformScale& b) { return a.scale == b.scale; }
+static bool sameStyleValue(const TransformScaleX& a, const TransformScaleX& b) { return a.scaleX == b.scaleX; }
+static bool sameStyleValue(const TransformScaleY& a, const TransformScaleY& b) { return a.scaleY == b.scaleY; }
+static bool sameStyleValue(const TransformTranslateX& a, const TransformTranslateX& b) { return a.translateX == b.translateX; }
+static bool sameStyleValue(const TransformTranslateY& a, const TransformTranslateY& b) { return a.translateY == b.translateY; }
+static bool sameStyleValue(const TransformSkewX& a, const TransformSkewX& b) { return a.skewX == b.skewX; }
+static bool sameStyleValue(const TransformSkewY& a, const TransformSkewY& b) { return a.skewY == b.skewY; }
+
+template <typename T>
+static bool sameStyleValue(const std::optional<T>& a, const std::optional<T>& b);
+template <typename... Ts>
+static bool sameStyleValue(const std::variant<Ts...>& a, const std::variant<Ts...>& b);
+template <typename T>
+static bool sameStyleValue(const std::vector<T>& a, const std::vector<T>& b);
+
+template <typename T>
+static bool sameStyleValue(const T& a, const T& b)
+{
+    return a == b;
+}
+
+template <typename T>
+static bool sameStyleValue(const std::optional<T>& a, const std::optional<T>& b)
+{
+    if (a.has_value() != b.has_value()) {
+        return false;
+    }
+    return !a.has_value() || sameStyleValue(*a, *b);
+}
+
+template <typename... Ts>
+static bool sameStyleValue(const std::variant<Ts...>& a, const std::variant<Ts...>& b)
+{
+    if (a.index() != b.index()) {
+        return false;
+    }
+    return std::visit(
+        [&](const auto& value) {
+            using T = std::decay_t<decltype(value)>;
+            return sameStyleValue(value, std::get<T>(b));
+        },
+        a);
+}
+
+template <typename T>
+static bool sameStyleValue(const std::vector<T>& a, const std::vector<T>& b)
+{
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (!sameStyleValue(a[i], b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Every NodeStyle field that is forwarded to the Yoga node.
+template <typename Fn>
+static void forEachYogaStyleField(Fn&& fn)
+{
+    fn(&NodeStyle::justifyContent);
+    fn(&NodeStyle::alignItems);
+    fn(&NodeStyle::alignSelf);
+    fn(&NodeStyle::alignContent);
+    fn(&NodeStyle::flexDirection);
+    fn(&NodeStyle::flexWrap);
+    fn(&NodeStyle::display);
+    fn(&NodeStyle::direction);
+    fn(&NodeStyle::position);
+    fn(&NodeStyle::overflow);
+    fn(&NodeStyle::boxSizing);
+    fn(&NodeStyle::flex);
+    fn(&NodeStyle::flexGrow);
+    fn(&NodeStyle::flexShrink);
+    fn(&NodeStyle::flexBasis);
+    fn(&NodeStyle::width);
+    fn(&NodeStyle::height);
+    fn(&NodeStyle::minWidth);
+    fn(&NodeStyle::minHeight);
+    fn(&NodeStyle::maxWidth);
+    fn(&NodeStyle::maxHeight);
+    fn(&NodeStyle::aspectRatio);
+    fn(&NodeStyle::top);
+    fn(&NodeStyle::bottom);
+    fn(&NodeStyle::left);
+    fn(&NodeStyle::right);
+    fn(&NodeStyle::start);
+    fn(&NodeStyle::end);
+    fn(&NodeStyle::margin);
+    fn(&NodeStyle::marginTop);
+    fn(&NodeStyle::marginBottom);
+    fn(&NodeStyle::marginLeft);
+    fn(&NodeStyle::marginRight);
+    fn(&NodeStyle::marginStart);
+    fn(&NodeStyle::marginEnd);
+    fn(&NodeStyle::marginHorizontal);
+    fn(&NodeStyle::marginVertical);
+    fn(&NodeStyle::padding);
+    fn(&NodeStyle::paddingTop);
+    fn(&NodeStyle::paddingBottom);
+    fn(&NodeStyle::paddingLeft);
+    fn(&NodeStyle::paddingRight);
+    fn(&NodeStyle::paddingStart);
+    fn(&NodeStyle::paddingEnd);
+    fn(&NodeStyle::paddingHorizontal);
+    fn(&NodeStyle::paddingVertical);
+    fn(&NodeStyle::borderWidth);
+    fn(&NodeStyle::borderTopWidth);
+    fn(&NodeStyle::borderBottomWidth);
+    fn(&NodeStyle::borderLeftWidth);
+    fn(&NodeStyle::borderRightWidth);
+    fn(&NodeStyle::borderStartWidth);
+    fn(&NodeStyle::borderEndWidth);
+    fn(&NodeStyle::borderHorizontalWidth);
+    fn(&NodeStyle::borderVerticalWidth);
+    fn(&NodeStyle::gap);
+    fn(&NodeStyle::rowGap);
+    fn(&NodeStyle::columnGap);
+    fn(&NodeStyle::inset);
+    fn(&NodeStyle::insetHorizontal);
+    fn(&NodeStyle::insetVertical);
+}
+
 void YogaNode::setStyle(const NodeStyle& style)
 {
-    std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
+    YogaTreeLock lock(*this);
     validateYogaLayoutUnitStrings(style);
     validateBackgroundColorString(style);
     validateFiniteNumericStyleFields(style);
     validateFiniteRadiusStyleFields(style);
     validateFiniteMatrixAndTransformStyleFields(style);
-    invalidateLayout();
-    _style = style;
-    resetYogaStyle(_node);
-    _paint = SkPaint();
-    _layerPaint.reset();
-    _clipsToBounds = false;
-    _clipToBoundsRadii.reset();
-    _clipPath.reset();
-    _clipRect.reset();
-    _clipRRect.reset();
-    _matrix.reset();
+
+    // Diff against the previous style so paint-only updates don't re-run Yoga
+    // and unchanged groups (paint, clip, matrix) keep their native state.
+    const NodeStyle& previous = _style;
+    auto changed = [&](auto field) {
+        return !sameStyleValue(previous.*field, style.*field);
+    };
+
+    bool layoutChanged = false;
+    bool resetLayout = false;
+    forEachYogaStyleField([&](auto field) {
+        if (changed(field)) {
+            layoutChanged = true;
+            // A removed prop has to fall back to Yoga's default, which only a
+            // full style reset can restore across all the edge/unit variants.
+            resetLayout = resetLayout || !(style.*field).has_value();
+        }
+    });
+
+    const bool needsParagraphWidthDefault =
+        _commandKind == YogaNodeCommandKind::PARAGRAPH && !style.width.has_value();
+    if (needsParagraphWidthDefault && !_usesParagraphWidthDefault) {
+        layoutChanged = true;
+    }
+
+    const bool paintChanged = changed(&NodeStyle::backgroundColor) || changed(&NodeStyle::borderWidth) ||
+        changed(&NodeStyle::strokeCap) || changed(&NodeStyle::strokeJoin) || changed(&NodeStyle::strokeMiter) ||
+        changed(&NodeStyle::dither) || changed(&NodeStyle::antiAlias) || changed(&NodeStyle::antiaAlias) ||
+        changed(&NodeStyle::opacity) || changed(&NodeStyle::blendMode);
+    const bool layerChanged = changed(&NodeStyle::layer);
+    const bool clipChanged = changed(&NodeStyle::overflow) || changed(&NodeStyle::borderRadius) ||
+        changed(&NodeStyle::borderTopLeftRadius) || changed(&NodeStyle::borderTopRightRadius) ||
+        changed(&NodeStyle::borderBottomRightRadius) || changed(&NodeStyle::borderBottomLeftRadius) ||
+        changed(&NodeStyle::clip) || changed(&NodeStyle::invertClip);
+    const auto styleMatrix = styleMatrixValue(style.matrix);
+    const bool matrixChanged = changed(&NodeStyle::transform) || styleMatrix != _appliedStyleMatrix;
+
+    if (layoutChanged) {
+        invalidateLayout();
+    } else if (paintChanged || layerChanged || clipChanged || matrixChanged) {
+        invalidateRasterCache();
+    }
+
+    if (resetLayout) {
+        resetYogaStyle(_node);
+        _usesParagraphWidthDefault = false;
+    }
+    auto applyLayout = [&](auto field) {
+        return resetLayout || changed(field);
+    };
 
     // Layout properties - using references to avoid multiple value() calls
-    if (const auto& value = style.justifyContent) {
+    if (const auto& value = style.justifyContent; value && applyLayout(&NodeStyle::justifyContent)) {
         YGNodeStyleSetJustifyContent(_node, static_cast<YGJustify>(*value));
     }
 
-    if (const auto& value = style.alignItems) {
+    if (const auto& value = style.alignItems; value && applyLayout(&NodeStyle::alignItems)) {
         YGNodeStyleSetAlignItems(_node, static_cast<YGAlign>(*value));
     }
 
-    if (const auto& value = style.alignSelf) {
+    if (const auto& value = style.alignSelf; value && applyLayout(&NodeStyle::alignSelf)) {
         YGNodeStyleSetAlignSelf(_node, static_cast<YGAlign>(*value));
     }
 
-    if (const auto& value = style.alignContent) {
+    if (const auto& value = style.alignContent; value && applyLayout(&NodeStyle::alignContent)) {
         YGNodeStyleSetAlignContent(_node, static_cast<YGAlign>(*value));
     }
 
-    if (const auto& value = style.flexDirection) {
+    if (const auto& value = style.flexDirection; value && applyLayout(&NodeStyle::flexDirection)) {
         YGNodeStyleSetFlexDirection(_node, static_cast<YGFlexDirection>(*value));
     }
 
-    if (const auto& value = style.flexWrap) {
+    if (const auto& value = style.flexWrap; value && applyLayout(&NodeStyle::flexWrap)) {
         YGNodeStyleSetFlexWrap(_node, static_cast<YGWrap>(*value));
     }
 
-    if (const auto& value = style.display) {
+    if (const auto& value = style.display; value && applyLayout(&NodeStyle::display)) {
         YGNodeStyleSetDisplay(_node, static_cast<YGDisplay>(*value));
     }
 
-    if (const auto& value = style.direction) {
+    if (const auto& value = style.direction; value && applyLayout(&NodeStyle::direction)) {
         YGNodeStyleSetDirection(_node, static_cast<YGDirection>(*value));
     }
 
-    if (const auto& value = style.position) {
+    if (const auto& value = style.position; value && applyLayout(&NodeStyle::position)) {
         YGNodeStyleSetPositionType(_node, static_cast<YGPositionType>(*value));
     }
 
-    if (const auto& value = style.overflow) {
+    if (const auto& value = style.overflow; value && applyLayout(&NodeStyle::overflow)) {
         YGNodeStyleSetOverflow(_node, static_cast<YGOverflow>(*value));
     }
 
-    if (const auto& value = style.boxSizing) {
+    if (const auto& value = style.boxSizing; value && applyLayout(&NodeStyle::boxSizing)) {
         YGNodeStyleSetBoxSizing(_node, static_cast<YGBoxSizing>(*value));
     }
 
     // Flex properties
-    if (const auto& value = style.flex) {
+    if (const auto& value = style.flex; value && applyLayout(&NodeStyle::flex)) {
         YGNodeStyleSetFlex(_node, toNativeStyleFloat("flex", *value));
     }
 
-    if (const auto& value = style.flexGrow) {
+    if (const auto& value = style.flexGrow; value && applyLayout(&NodeStyle::flexGrow)) {
         YGNodeStyleSetFlexGrow(_node, toNativeStyleFloat("flexGrow", *value));
     }
 
-    if (const auto& value = style.flexShrink) {
+    if (const auto& value = style.flexShrink; value && applyLayout(&NodeStyle::flexShrink)) {
         YGNodeStyleSetFlexShrink(_node, toNativeStyleFloat("flexShrink", *value));
     }
 
-    if (const auto& value = style.flexBasis) {
+    if (const auto& value = style.flexBasis; value && applyLayout(&NodeStyle::flexBasis)) {
         setYGValueOrPercent(YGNodeStyleSetFlexBasis, YGNodeStyleSetFlexBasisPercent,
             YGNodeStyleSetFlexBasisAuto, _node, *value, "flexBasis");
     }
 
     // Size properties
-    if (const auto& value = style.width) {
+    if (const auto& value = style.width; value && applyLayout(&NodeStyle::width)) {
         setYGWidthValue(_node, *value);
-    } else if (_commandKind == YogaNodeCommandKind::PARAGRAPH) {
+    } else if (needsParagraphWidthDefault && (resetLayout || !_usesParagraphWidthDefault)) {
         // default width for paragraphs is to stretch but not beyond
         YGNodeStyleSetWidthStretch(_node);
     }
+    _usesParagraphWidthDefault = needsParagraphWidthDefault;
 
-    if (const auto& value = style.height) {
+    if (const auto& value = style.height; value && applyLayout(&NodeStyle::height)) {
         setYGValueOrPercent(YGNodeStyleSetHeight, YGNodeStyleSetHeightPercent,
             YGNodeStyleSetHeightAuto, _node, *value, "height");
     }
 
-    if (const auto& value = style.minWidth) {
+    if (const auto& value = style.minWidth; value && applyLayout(&NodeStyle::minWidth)) {
         setYGValueOrPercent(YGNodeStyleSetMinWidth, YGNodeStyleSetMinWidthPercent,
             nullptr, _node, *value, "minWidth");
     }
 
-    if (const auto& value = style.minHeight) {
+    if (const auto& value = style.minHeight; value && applyLayout(&NodeStyle::minHeight)) {
         setYGValueOrPercent(YGNodeStyleSetMinHeight, YGNodeStyleSetMinHeightPercent,
             nullptr, _node, *value, "minHeight");
     }
 
-    if (const auto& value = style.maxWidth) {
+    if (const auto& value = style.maxWidth; value && applyLayout(&NodeStyle::maxWidth)) {
         setYGValueOrPercent(YGNodeStyleSetMaxWidth, YGNodeStyleSetMaxWidthPercent,
             nullptr, _node, *value, "maxWidth");
     }
 
-    if (const auto& value = style.maxHeight) {
+    if (const auto& value = style.maxHeight; value && applyLayout(&NodeStyle::maxHeight)) {
         setYGValueOrPercent(YGNodeStyleSetMaxHeight, YGNodeStyleSetMaxHeightPercent,
             nullptr, _node, *value, "maxHeight");
     }
 
     // Aspect ratio
-    if (const auto& value = style.aspectRatio) {
+    if (const auto& value = style.aspectRatio; value && applyLayout(&NodeStyle::aspectRatio)) {
         YGNodeStyleSetAspectRatio(_node, toNativeStyleFloat("aspectRatio", *value));
     }
 
     // Position properties
-    if (const auto& value = style.top) {
+    if (const auto& value = style.top; value && applyLayout(&NodeStyle::top)) {
         setYGEdgeValue(YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent,
             YGNodeStyleSetPositionAuto, _node, YGEdgeTop, *value, "top");
     }
 
-    if (const auto& value = style.bottom) {
+    if (const auto& value = style.bottom; value && applyLayout(&NodeStyle::bottom)) {
         setYGEdgeValue(YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent,
             YGNodeStyleSetPositionAuto, _node, YGEdgeBottom, *value, "bottom");
     }
 
-    if (const auto& value = style.left) {
+    if (const auto& value = style.left; value && applyLayout(&NodeStyle::left)) {
         setYGEdgeValue(YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent,
             YGNodeStyleSetPositionAuto, _node, YGEdgeLeft, *value, "left");
     }
 
-    if (const auto& value = style.right) {
+    if (const auto& value = style.right; value && applyLayout(&NodeStyle::right)) {
         setYGEdgeValue(YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent,
             YGNodeStyleSetPositionAuto, _node, YGEdgeRight, *value, "right");
     }
 
-    if (const auto& value = style.start) {
+    if (const auto& value = style.start; value && applyLayout(&NodeStyle::start)) {
         setYGEdgeValue(YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent,
             YGNodeStyleSetPositionAuto, _node, YGEdgeStart, *value, "start");
     }
 
-    if (const auto& value = style.end) {
+    if (const auto& value = style.end; value && applyLayout(&NodeStyle::end)) {
         setYGEdgeValue(YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent,
             YGNodeStyleSetPositionAuto, _node, YGEdgeEnd, *value, "end");
     }
 
     // Margin properties
-    if (const auto& value = style.margin) {
+    if (const auto& value = style.margin; value && applyLayout(&NodeStyle::margin)) {
         setYGEdgeValue(YGNodeStyleSetMargin, YGNodeStyleSetMarginPercent,
             YGNodeStyleSetMarginAuto, _node, YGEdgeAll, *value, "margin");
     }
 
-    if (const auto& value = style.marginTop) {
+    if (const auto& value = style.marginTop; value && applyLayout(&NodeStyle::marginTop)) {
         setYGEdgeValue(YGNodeStyleSetMargin, YGNodeStyleSetMarginPercent,
             YGNodeStyleSetMarginAuto, _node, YGEdgeTop, *value, "marginTop");
     }
 
-    if (const auto& value = style.marginBottom) {
+    if (const auto& value = style.marginBottom; value && applyLayout(&NodeStyle::marginBottom)) {
         setYGEdgeValue(YGNodeStyleSetMargin, YGNodeStyleSetMarginPercent,
             YGNodeStyleSetMarginAuto, _node, YGEdgeBottom, *value, "marginBottom");
     }
 
-    if (const auto& value = style.marginLeft) {
+    if (const auto& value = style.marginLeft; value && applyLayout(&NodeStyle::marginLeft)) {
         setYGEdgeValue(YGNodeStyleSetMargin, YGNodeStyleSetMarginPercent,
             YGNodeStyleSetMarginAuto, _node, YGEdgeLeft, *value, "marginLeft");
     }
 
-    if (const auto& value = style.marginRight) {
+    if (const auto& value = style.marginRight; value && applyLayout(&NodeStyle::marginRight)) {
         setYGEdgeValue(YGNodeStyleSetMargin, YGNodeStyleSetMarginPercent,
             YGNodeStyleSetMarginAuto, _node, YGEdgeRight, *value, "marginRight");
     }
 
-    if (const auto& value = style.marginStart) {
+    if (const auto& value = style.marginStart; value && applyLayout(&NodeStyle::marginStart)) {
         setYGEdgeValue(YGNodeStyleSetMargin, YGNodeStyleSetMarginPercent,
             YGNodeStyleSetMarginAuto, _node, YGEdgeStart, *value, "marginStart");
     }
 
-    if (const auto& value = style.marginEnd) {
+    if (const auto& value = style.marginEnd; value && applyLayout(&NodeStyle::marginEnd)) {
         setYGEdgeValue(YGNodeStyleSetMargin, YGNodeStyleSetMarginPercent,
             YGNodeStyleSetMarginAuto, _node, YGEdgeEnd, *value, "marginEnd");
     }
 
-    if (const auto& value = style.marginHorizontal) {
+    if (const auto& value = style.marginHorizontal; value && applyLayout(&NodeStyle::marginHorizontal)) {
         setYGEdgeValue(YGNodeStyleSetMargin, YGNodeStyleSetMarginPercent,
             YGNodeStyleSetMarginAuto, _node, YGEdgeHorizontal, *value, "marginHorizontal");
     }
 
-    if (const auto& value = style.marginVertical) {
+    if (const auto& value = style.marginVertical; value && applyLayout(&NodeStyle::marginVertical)) {
         setYGEdgeValue(YGNodeStyleSetMargin, YGNodeStyleSetMarginPercent,
             YGNodeStyleSetMarginAuto, _node, YGEdgeVertical, *value, "marginVertical");
     }
 
     // Padding properties
-    if (const auto& value = style.padding) {
+    if (const auto& value = style.padding; value && applyLayout(&NodeStyle::padding)) {
         setYGEdgeValue(YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent,
             nullptr, _node, YGEdgeAll, *value, "padding");
     }
 
-    if (const auto& value = style.paddingTop) {
+    if (const auto& value = style.paddingTop; value && applyLayout(&NodeStyle::paddingTop)) {
         setYGEdgeValue(YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent,
             nullptr, _node, YGEdgeTop, *value, "paddingTop");
     }
 
-    if (const auto& value = style.paddingBottom) {
+    if (const auto& value = style.paddingBottom; value && applyLayout(&NodeStyle::paddingBottom)) {
         setYGEdgeValue(YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent,
             nullptr, _node, YGEdgeBottom, *value, "paddingBottom");
     }
 
-    if (const auto& value = style.paddingLeft) {
+    if (const auto& value = style.paddingLeft; value && applyLayout(&NodeStyle::paddingLeft)) {
         setYGEdgeValue(YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent,
             nullptr, _node, YGEdgeLeft, *value, "paddingLeft");
     }
 
-    if (const auto& value = style.paddingRight) {
+    if (const auto& value = style.paddingRight; value && applyLayout(&NodeStyle::paddingRight)) {
         setYGEdgeValue(YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent,
             nullptr, _node, YGEdgeRight, *value, "paddingRight");
     }
 
-    if (const auto& value = style.paddingStart) {
+    if (const auto& value = style.paddingStart; value && applyLayout(&NodeStyle::paddingStart)) {
         setYGEdgeValue(YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent,
             nullptr, _node, YGEdgeStart, *value, "paddingStart");
     }
 
-    if (const auto& value = style.paddingEnd) {
+    if (const auto& value = style.paddingEnd; value && applyLayout(&NodeStyle::paddingEnd)) {
         setYGEdgeValue(YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent,
             nullptr, _node, YGEdgeEnd, *value, "paddingEnd");
     }
 
-    if (const auto& value = style.paddingHorizontal) {
+    if (const auto& value = style.paddingHorizontal; value && applyLayout(&NodeStyle::paddingHorizontal)) {
         setYGEdgeValue(YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent,
             nullptr, _node, YGEdgeHorizontal, *value, "paddingHorizontal");
     }
 
-    if (const auto& value = style.paddingVertical) {
+    if (const auto& value = style.paddingVertical; value && applyLayout(&NodeStyle::paddingVertical)) {
         setYGEdgeValue(YGNodeStyleSetPadding, YGNodeStyleSetPaddingPercent,
             nullptr, _node, YGEdgeVertical, *value, "paddingVertical");
     }
 
-    if (const auto& value = style.backgroundColor) {
-
-        if (std::holds_alternative<std::string>(*value)) {
-            const auto& str = std::get<std::string>(*value);
-            if (auto parsed = parseCssColor(str)) {
-                _paint.setColor(*parsed);
-            }
-        } else {
-            // backgroundColor is a SkPaint
-            const auto& p = std::get<SkPaint>(*value);
-            _paint = p;
-        }
-    }
-
     // Border properties
-    if (const auto& value = style.borderWidth) {
-        auto val = toNativeStyleFloat("borderWidth", *value);
-        YGNodeStyleSetBorder(_node, YGEdgeAll, val);
-        _paint.setStrokeWidth(val);
-    }
-
-    if (const auto& value = style.strokeCap) {
-        _paint.setStrokeCap(static_cast<SkPaint::Cap>(*value));
-    }
-
-    if (const auto& value = style.strokeJoin) {
-        _paint.setStrokeJoin(static_cast<SkPaint::Join>(*value));
-    }
-
-    if (const auto& value = style.strokeMiter) {
-        _paint.setStrokeMiter(*value);
+    if (const auto& value = style.borderWidth; value && applyLayout(&NodeStyle::borderWidth)) {
+        YGNodeStyleSetBorder(_node, YGEdgeAll, toNativeStyleFloat("borderWidth", *value));
     }
 
-    if (const auto& value = style.borderTopWidth) {
+    if (const auto& value = style.borderTopWidth; value && applyLayout(&NodeStyle::borderTopWidth)) {
         YGNodeStyleSetBorder(_node, YGEdgeTop, toNativeStyleFloat("borderTopWidth", *value));
     }
 
-    if (const auto& value = style.borderBottomWidth) {
+    if (const auto& value = style.borderBottomWidth; value && applyLayout(&NodeStyle::borderBottomWidth)) {
         YGNodeStyleSetBorder(_node, YGEdgeBottom, toNativeStyleFloat("borderBottomWidth", *value));
     }
 
-    if (const auto& value = style.borderLeftWidth) {
+    if (const auto& value = style.borderLeftWidth; value && applyLayout(&NodeStyle::borderLeftWidth)) {
         YGNodeStyleSetBorder(_node, YGEdgeLeft, toNativeStyleFloat("borderLeftWidth", *value));
     }
 
-    if (const auto& value = style.borderRightWidth) {
+    if (const auto& value = style.borderRightWidth; value && applyLayout(&NodeStyle::borderRightWidth)) {
         YGNodeStyleSetBorder(_node, YGEdgeRight, toNativeStyleFloat("borderRightWidth", *value));
     }
 
-    if (const auto& value = style.borderStartWidth) {
+    if (const auto& value = style.borderStartWidth; value && applyLayout(&NodeStyle::borderStartWidth)) {
         YGNodeStyleSetBorder(_node, YGEdgeStart, toNativeStyleFloat("borderStartWidth", *value));
     }
 
-    if (const auto& value = style.borderEndWidth) {
+    if (const auto& value = style.borderEndWidth; value && applyLayout(&NodeStyle::borderEndWidth)) {
         YGNodeStyleSetBorder(_node, YGEdgeEnd, toNativeStyleFloat("borderEndWidth", *value));
     }
 
-    if (const auto& value = style.borderHorizontalWidth) {
+    if (const auto& value = style.borderHorizontalWidth; value && applyLayout(&NodeStyle::borderHorizontalWidth)) {
         float width = toNativeStyleFloat("borderHorizontalWidth", *value);
         YGNodeStyleSetBorder(_node, YGEdgeHorizontal, width);
     }
 
-    if (const auto& value = style.borderVerticalWidth) {
+    if (const auto& value = style.borderVerticalWidth; value && applyLayout(&NodeStyle::borderVerticalWidth)) {
         float width = toNativeStyleFloat("borderVerticalWidth", *value);
         YGNodeStyleSetBorder(_node, YGEdgeVertical, width);
     }
 
     // Gap properties
-    if (const auto& value = style.gap) {
+    if (const auto& value = style.gap; value && applyLayout(&NodeStyle::gap)) {
         YGNodeStyleSetGap(_node, YGGutterAll, toNativeStyleFloat("gap", *value));
     }
 
-    if (const auto& value = style.rowGap) {
+    if (const auto& value = style.rowGap; value && applyLayout(&NodeStyle::rowGap)) {
         YGNodeStyleSetGap(_node, YGGutterRow, toNativeStyleFloat("rowGap", *value));
     }
 
-    if (const auto& value = style.columnGap) {
+    if (const auto& value = style.columnGap; value && applyLayout(&NodeStyle::columnGap)) {
         YGNodeStyleSetGap(_node, YGGutterColumn, toNativeStyleFloat("columnGap", *value));
     }
 
     // Inset properties: TODO object
-    if (const auto& value = style.inset) {
+    if (const auto& value = style.inset; value && applyLayout(&NodeStyle::inset)) {
         // Apply to all edges
         setYGEdgeValue(YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent,
             YGNodeStyleSetPositionAuto, _node, YGEdgeAll, *value, "inset");
     }
 
-    if (const auto& value = style.insetHorizontal) {
+    if (const auto& value = style.insetHorizontal; value && applyLayout(&NodeStyle::insetHorizontal)) {
         setYGEdgeValue(YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent,
             YGNodeStyleSetPositionAuto, _node, YGEdgeHorizontal, *value, "insetHorizontal");
     }
 
-    if (const auto& value = style.insetVertical) {
+    if (const auto& value = style.insetVertical; value && applyLayout(&NodeStyle::insetVertical)) {
         setYGEdgeValue(YGNodeStyleSetPosition, YGNodeStyleSetPositionPercent,
             YGNodeStyleSetPositionAuto, _node, YGEdgeVertical, *value, "insetVertical");
     }
 
-    if (const auto& value = style.layer) {
-        _layerPaint = *value;
+    if (paintChanged) {
+        _paint = SkPaint();
+
+        if (const auto& value = style.backgroundColor) {
+            if (std::holds_alternative<std::string>(*value)) {
+                const auto& str = std::get<std::string>(*value);
+                if (auto parsed = parseCssColor(str)) {
+                    _paint.setColor(*parsed);
+                }
+            } else {
+                // backgroundColor is a SkPaint
+                const auto& p = std::get<SkPaint>(*value);
+                _paint = p;
+            }
+        }
+
+        if (const auto& value = style.borderWidth) {
+            _paint.setStrokeWidth(toNativeStyleFloat("borderWidth", *value));
+        }
+
+        if (const auto& value = style.strokeCap) {
+            _paint.setStrokeCap(static_cast<SkPaint::Cap>(*value));
+        }
+
+        if (const auto& value = style.strokeJoin) {
+            _paint.setStrokeJoin(static_cast<SkPaint::Join>(*value));
+        }
+
+        if (const auto& value = style.strokeMiter) {
+            _paint.setStrokeMiter(*value);
+        }
+
+        if (const auto& value = style.dither) {
+            _paint.setDither(*value);
+        }
+
+        if (const auto& value = style.antiAlias.has_value() ? style.antiAlias : style.antiaAlias) {
+            _paint.setAntiAlias(*value);
+        }
+
+        if (const auto& value = style.opacity) {
+            _paint.setAlphaf(toNativeStyleFloat("opacity", *value));
+        }
+
+        if (const auto& value = style.blendMode) {
+            _paint.setBlendMode(static_cast<SkBlendMode>(*value));
+        }
     }
 
-    if (const auto& value = style.dither) {
-        _paint.setDither(*value);
+    if (layerChanged) {
+        _layerPaint = style.layer;
     }
 
-    if (const auto& value = style.antiAlias.has_value() ? style.antiAlias : style.antiaAlias) {
-        _paint.setAntiAlias(*value);
+    if (clipChanged) {
+        applyClipStyle(style);
     }
 
-    if (const auto& value = style.opacity) {
-        _paint.setAlphaf(toNativeStyleFloat("opacity", *value));
+    if (matrixChanged) {
+        applyMatrixStyle(style);
     }
 
-    if (const auto& value = style.blendMode) {
-        _paint.setBlendMode(static_cast<SkBlendMode>(*value));
+    // The hit-test index bakes in matrices and which ancestors clip; paint
+    // changes leave it alone and layout moves mark it in recursiveSetLayout.
+    if (clipChanged || matrixChanged) {
+        markHitTestIndexDirty();
     }
 
+    _appliedStyleMatrix = styleMatrix;
+    _style = style;
+}
+
+void YogaNode::applyClipStyle(const NodeStyle& style)
+{
     const bool clipsOverflow =
         style.overflow.has_value() &&
         (style.overflow.value() == Overflow::HIDDEN || style.overflow.value() == Overflow::SCROLL);
@@ -1352,6 +1696,7 @@ void YogaNode::setStyle(const NodeStyle& style)
             _clipRect.reset();
         } else if (std::holds_alternative<SkRRect>(*value)) {
             _clipRRect = std::get<SkRRect>(*value);
+            _clipRRectPath = detail::makePath(*_clipRRect);
             _clipPath.reset();
             _clipRect.reset();
         } else if (std::holds_alternative<SkRect>(*value)) {
@@ -1366,12 +1711,18 @@ void YogaNode::setStyle(const NodeStyle& style)
         _clipRect.reset();
     }
 
-    auto applyMatrixStyle = [&]() {
-        if (const auto& value = style.matrix) {
-            _matrix = makeMatrixPointer(*value);
-        } else {
-            _matrix.reset();
-        }
+    if (!_clipRRect.has_value()) {
+        _clipRRectPath.reset();
+    }
+    updateClipGeometry();
+}
+
+void YogaNode::applyMatrixStyle(const NodeStyle& style)
+{
+    auto applyMatrixValue = [&]() {
+        // Copied so an in-place mutation of a JsiSkMatrix cannot change what
+        // is drawn without also refreshing the cached inverse.
+        _matrix = styleMatrixValue(style.matrix);
     };
 
     if (const auto& value = style.transform) {
@@ -1439,18 +1790,36 @@ void YogaNode::setStyle(const NodeStyle& style)
         }
 
         if (hasTransform) {
-            _matrix = std::make_shared<SkMatrix>(matrix.asM33());
+            _matrix = matrix.asM33();
         } else {
-            applyMatrixStyle();
+            applyMatrixValue();
         }
     } else {
-        applyMatrixStyle();
+        applyMatrixValue();
+    }
+
+    // Hit testing maps every point through the inverse; a singular matrix
+    // leaves it empty and makes the subtree unhittable.
+    _inverseMatrix.reset();
+    SkMatrix inverse;
+    if (_matrix.has_value() && _matrix->invert(&inverse)) {
+        _inverseMatrix = inverse;
+    }
+}
+
+// Geometry derived from clip style and layout size, kept so hit tests and
+// draws don't rebuild it.
+void YogaNode::updateClipGeometry()
+{
+    if (_clipToBoundsRadii.has_value()) {
+        _clipToBoundsRRect = detail::makeRoundedRect(_layout, *_clipToBoundsRadii);
+    } else {
+        _clipToBoundsRRect.reset();
     }
 }
 
 void YogaNode::insertChild(const std::shared_ptr<HybridYogaNodeSpec>& child, const std::optional<std::variant<double, std::shared_ptr<HybridYogaNodeSpec>>>& index)
 {
-    std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
     if (!child) {
         return; // No child to insert
     }
@@ -1461,6 +1830,8 @@ void YogaNode::insertChild(const std::shared_ptr<HybridYogaNodeSpec>& child, con
         throw std::runtime_error("Child is not a YogaNode");
     }
 
+    YogaTreeLock lock(*this, *yogaNode);
+
     if (_node == nullptr || yogaNode->_node == nullptr) {
         throw std::runtime_error("Cannot insert a disposed YogaNode");
     }
@@ -1512,7 +1883,7 @@ void YogaNode::insertChild(const std::shared_ptr<HybridYogaNodeSpec>& child, con
     }
 
     if (auto oldParent = yogaNode->_parent.lock()) {
-        detachChildFromParent(*oldParent, yogaNode);
+        detachChildFromParent(*oldParent, yogaNode, treeMutex());
     } else if (YGNodeGetParent(yogaNode->_node) != nullptr) {
         throw std::runtime_error("Cannot insert YogaNode because its Yoga owner has no live YogaNode parent link");
     }
@@ -1550,14 +1921,16 @@ void YogaNode::insertChild(const std::shared_ptr<HybridYogaNodeSpec>& child, con
     }
 
     yogaNode->_parent = parentSelf;
+    yogaNode->adoptTreeMutex(treeMutex());
     adjustInteractiveDescendantCount(yogaNode->_interactiveDescendantCount);
+    invalidateAnimatedCells();
     invalidateLayout();
+    markHitTestIndexDirty();
 }
 
 // void removeChild(const std::shared_ptr<HybridYogaNodeSpec>& child) override;
 void YogaNode::removeChild(const std::shared_ptr<HybridYogaNodeSpec>& c)
 {
-    std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
     if (!c) {
         return;
     }
@@ -1567,19 +1940,21 @@ void YogaNode::removeChild(const std::shared_ptr<HybridYogaNodeSpec>& c)
         throw std::runtime_error("Child is not a YogaNode");
     }
 
-    detachChildFromParent(*this, child);
+    YogaTreeLock lock(*this, *child);
+    detachChildFromParent(*this, child, std::make_shared<std::recursive_mutex>());
 }
 
 void YogaNode::removeAllChildren()
 {
-    std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
+    YogaTreeLock lock(*this);
     detachAllChildren(*this, true);
 }
 
 void YogaNode::setCommand(NodeCommand command)
 {
-    std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
+    YogaTreeLock lock(*this);
     invalidateRasterCache();
+    invalidateAnimatedCells();
 
     auto* runtime = RNJsi::BaseRuntimeAwareCache::getMainJsRuntime();
     if (runtime == nullptr) {
@@ -1655,10 +2030,17 @@ void YogaNode::setCommand(NodeCommand command)
             _command = std::make_unique<ParagraphCmd>(this, *runtime, variables);
             _commandKind = YogaNodeCommandKind::PARAGRAPH;
             YGNodeSetMeasureFunc(_node, margelo::nitro::RNSkiaYoga::ParagraphCmd::measureFunc);
+            YGNodeSetBaselineFunc(_node, margelo::nitro::RNSkiaYoga::ParagraphCmd::baselineFunc);
         } else if (_commandKind != YogaNodeCommandKind::PARAGRAPH) {
             throw std::runtime_error("YogaNode command type cannot change after initialization.");
         }
-        static_cast<ParagraphCmd*>(_command.get())->updateProps(std::get<ParagraphCommandData>(command.data));
+        // New text changes the measured size, which Yoga cannot see on its own.
+        // Re-commits of unchanged labels reinstall the cached paragraph and
+        // leave the layout alone.
+        if (static_cast<ParagraphCmd*>(_command.get())->updateProps(std::get<ParagraphCommandData>(command.data))) {
+            YGNodeMarkDirty(_node);
+            markLayoutDirty();
+        }
         break;
     case NodeCommandKind::CIRCLE:
         if (_commandKind == YogaNodeCommandKind::NONE) {
@@ -1701,37 +2083,90 @@ void YogaNode::setCommand(NodeCommand command)
 jsi::Value YogaNode::draw(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count)
 {
     return withJsiError(runtime, "YogaNode.draw()", [&]() -> jsi::Value {
-        std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
+        YogaTreeLock lock(*this);
         (void)thisArg;
         (void)args;
         (void)count;
         jsi::Object props = jsi::Object(runtime);
         SkPictureRecorder pictureRecorder;
-        SkISize size = SkISize::Make(2'000'000, 2'000'000);
-        SkRect rect = SkRect::Make(size);
-        auto canvas = pictureRecorder.beginRecording(rect, nullptr);
+        auto canvas = pictureRecorder.beginRecording(kPictureRecordingBounds, nullptr);
         RNSkia::DrawingCtx ctx(canvas);
 
         if (!_command) {
             return jsi::Value::undefined();
         }
 
-        drawInternal(ctx);
+        updateLayout();
+        sampleAnimatedValues();
+        drawDisplayList(ctx);
+        clearPaintDirty();
 
         auto picture = pictureRecorder.finishRecordingAsPicture();
         return jsi::Object::createFromHostObject(runtime, std::make_shared<RNSkia::JsiSkPicture>(GetPlatformContext(), picture));
     });
 }
 
+// Records the tree into an immutable picture that the render thread can replay
+// without taking the tree lock. Trees with animated content return nullptr and
+// keep drawing live, since their output changes without a commit.
+sk_sp<SkPicture> YogaNode::recordSnapshot(float pixelDensity, std::vector<YogaSnapshotCullEntry>& cullEntries)
+{
+    YogaTreeLock lock(*this);
+
+    cullEntries.clear();
+    if (!_command || subtreeHasDynamicRasterContent()) {
+        return nullptr;
+    }
+
+    // The R-tree lets partial redraws replay only the ops under the damage.
+    SkRTreeFactory bboxFactory;
+    SkPictureRecorder pictureRecorder;
+    auto canvas = pictureRecorder.beginRecording(kPictureRecordingBounds, &bboxFactory);
+    // Recorded in device pixels so rasterized groups are cached at the density
+    // the snapshot is replayed at.
+    canvas->scale(pixelDensity, pixelDensity);
+    RNSkia::DrawingCtx ctx(canvas);
+    updateLayout();
+    {
+        struct RecordingSnapshotScope {
+            RecordingSnapshotScope() { sRecordingSnapshot = true; }
+            ~RecordingSnapshotScope() { sRecordingSnapshot = false; }
+        } recordingSnapshotScope;
+        drawDisplayList(ctx);
+    }
+    clearPaintDirty();
+
+    const auto densityMatrix = SkMatrix::Scale(pixelDensity, pixelDensity);
+    for (const auto& op : _displayList) {
+        if (!op.cullBounds.has_value()) {
+            continue;
+        }
+        switch (op.kind) {
+        case YogaDisplayListOpKind::DRAW:
+            cullEntries.push_back({ densityMatrix.mapRect(*op.cullBounds), 1 });
+            break;
+        case YogaDisplayListOpKind::DELEGATE:
+        case YogaDisplayListOpKind::PICTURE:
+            cullEntries.push_back({ densityMatrix.mapRect(*op.cullBounds), op.node->_subtreeNodeCount });
+            break;
+        default:
+            break;
+        }
+    }
+    return pictureRecorder.finishRecordingAsPicture();
+}
+
 void YogaNode::renderToContext(RNSkia::DrawingCtx& ctx)
 {
-    std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
+    YogaTreeLock lock(*this);
 
     if (!_command) {
         return;
     }
 
-    drawInternal(ctx);
+    updateLayout();
+    drawDisplayList(ctx);
+    clearPaintDirty();
 }
 
 void YogaNode::drawInternal(RNSkia::DrawingCtx& ctx)
@@ -1740,8 +2175,6 @@ void YogaNode::drawInternal(RNSkia::DrawingCtx& ctx)
         return;
     }
 
-    auto op = _style.invertClip.has_value() && _style.invertClip.value() ? SkClipOp::kDifference : SkClipOp::kIntersect;
-
     if (_layerPaint.has_value()) {
         const SkPaint* paint = &(_layerPaint.value());
         ctx.canvas->saveLayer(nullptr, paint);
@@ -1749,53 +2182,15 @@ void YogaNode::drawInternal(RNSkia::DrawingCtx& ctx)
         ctx.canvas->save();
     }
 
-    if (!_hasLayoutBeenComputed) {
-        computeLayout(std::nullopt, std::nullopt);
-    }
-
     ctx.canvas->translate(_layout.left, _layout.top);
 
     if (_matrix) {
         ctx.canvas->concat(*_matrix);
     }
 
-    if (_clipsToBounds) {
-        if (_clipToBoundsRadii.has_value()) {
-            const auto clipBounds = detail::makeRoundedRect(_layout, *_clipToBoundsRadii);
-            const auto clipPath = detail::makePath(clipBounds);
-            ctx.canvas->clipPath(clipPath, SkClipOp::kIntersect, true);
-        } else {
-            ctx.canvas->clipRect(
-                SkRect::MakeXYWH(0, 0, _layout.width, _layout.height),
-                SkClipOp::kIntersect,
-                true);
-        }
-    }
-
-    if (_clipPath.has_value()) {
-        ctx.canvas->clipPath(*_clipPath, op, true);
-    } else if (_clipRect.has_value()) {
-        ctx.canvas->clipRect(*_clipRect, op, true);
-    } else if (_clipRRect.has_value()) {
-        ctx.canvas->clipRRect(*_clipRRect, op, true);
-    }
-
-    auto paint = _paint;
-    // Command-specific text color is only used when the current style snapshot
-    // did not supply its own paint color. Style still wins when it is explicit.
-    if (!_style.backgroundColor.has_value()) {
-        if (const auto fallbackColor = _command->fallbackPaintColor()) {
-            if (_style.opacity.has_value()) {
-                paint.setColor(SkColorSetA(*fallbackColor, SkColorGetA(paint.getColor())));
-            } else {
-                paint.setColor(*fallbackColor);
-            }
-        }
-    }
-
-    auto maskFilter = ctx.getPaint().refMaskFilter();
-    paint.setMaskFilter(maskFilter);
+    applyClips(ctx.canvas);
 
+    auto paint = resolveDrawPaint(ctx.getPaint().refMaskFilter());
     ctx.pushPaint(paint);
 
     _command->draw(&ctx);
@@ -1803,23 +2198,37 @@ void YogaNode::drawInternal(RNSkia::DrawingCtx& ctx)
     if (_command->rasterizesSubtree()) {
         const auto width = std::max(1, static_cast<int>(std::ceil(_layout.width)));
         const auto height = std::max(1, static_cast<int>(std::ceil(_layout.height)));
+        const auto scale = rasterCacheScale(ctx.canvas->getTotalMatrix());
+        const auto dst = SkRect::MakeWH(static_cast<float>(width), static_cast<float>(height));
+        const SkSamplingOptions sampling(SkFilterMode::kLinear);
         const auto hasDynamicContent = subtreeHasDynamicRasterContent();
-        const auto canReuseRasterCache =
-            !hasDynamicContent &&
-            !_rasterCacheDirty &&
-            _rasterCache != nullptr &&
-            _rasterCacheWidth == width &&
-            _rasterCacheHeight == height;
-
-        if (canReuseRasterCache) {
-            ctx.canvas->drawImage(_rasterCache, 0.0f, 0.0f);
+        auto& rasterCache = RasterCacheManager::shared();
+        sk_sp<SkImage> cachedImage;
+        if (!sRecordingSnapshot && !hasDynamicContent && !_rasterCacheDirty) {
+            cachedImage = rasterCache.find(this, width, height, scale);
+        }
+
+        if (sRecordingSnapshot) {
+            // Clipped like the image would be, so the snapshot matches a live
+            // frame.
+            ctx.canvas->clipRect(dst);
+            drawChildren(ctx);
+        } else if (cachedImage != nullptr) {
+            ctx.canvas->drawImageRect(cachedImage, dst, sampling);
         } else {
-            const auto imageInfo = SkImageInfo::MakeN32Premul(width, height);
+            // The surface is sized in device pixels so the cached image stays
+            // sharp under the pixel density and transforms applied above it.
+            const auto pixelWidth = std::max(1, static_cast<int>(std::ceil(width * scale)));
+            const auto pixelHeight = std::max(1, static_cast<int>(std::ceil(height * scale)));
+            const auto imageInfo = SkImageInfo::MakeN32Premul(pixelWidth, pixelHeight);
             const auto surface = SkSurfaces::Raster(imageInfo);
 
             if (surface != nullptr) {
                 auto* offscreenCanvas = surface->getCanvas();
                 offscreenCanvas->clear(SK_ColorTRANSPARENT);
+                offscreenCanvas->scale(
+                    static_cast<float>(pixelWidth) / width,
+                    static_cast<float>(pixelHeight) / height);
 
                 RNSkia::DrawingCtx offscreenCtx(offscreenCanvas);
                 auto maskFilter = ctx.getPaint().refMaskFilter();
@@ -1831,16 +2240,14 @@ void YogaNode::drawInternal(RNSkia::DrawingCtx& ctx)
                 const auto image = surface->makeImageSnapshot();
                 if (image != nullptr) {
                     if (hasDynamicContent) {
-                        _rasterCache.reset();
+                        rasterCache.erase(this);
                         _rasterCacheDirty = true;
                     } else {
-                        _rasterCache = image;
+                        rasterCache.store(this, image, width, height, scale);
                         _rasterCacheDirty = false;
                     }
 
-                    _rasterCacheWidth = width;
-                    _rasterCacheHeight = height;
-                    ctx.canvas->drawImage(image, 0.0f, 0.0f);
+                    ctx.canvas->drawImageRect(image, dst, sampling);
                 }
             }
         }
@@ -1855,92 +2262,832 @@ void YogaNode::drawInternal(RNSkia::DrawingCtx& ctx)
 
 void YogaNode::drawChildren(RNSkia::DrawingCtx& ctx)
 {
+    const auto localClipBounds = ctx.canvas->getLocalClipBounds();
     for (const auto& child : _children) {
-        if (!child->_hasLayoutBeenComputed) {
-            child->computeLayout(_layout.width, _layout.height);
+        if (!child->_command) {
+            continue;
         }
 
-        if (child->_command) {
-            child->drawInternal(ctx);
+        if (child->isOutsideClip(localClipBounds)) {
+            sCulledNodeCount += child->_subtreeNodeCount;
+            continue;
         }
+
+        child->drawInternal(ctx);
     }
 }
 
-bool YogaNode::subtreeHasDynamicRasterContent() const
+void YogaNode::applyClips(SkCanvas* canvas) const
 {
-    if (_command && _command->isDynamic()) {
-        return true;
-    }
-
-    for (const auto& child : _children) {
-        if (child->subtreeHasDynamicRasterContent()) {
-            return true;
+    if (_clipsToBounds) {
+        // Rounded overflow clips are plain rounded rects; clipRRect keeps them
+        // on Skia's analytic clip path instead of building an SkPath per draw.
+        if (_clipToBoundsRRect.has_value()) {
+            canvas->clipRRect(*_clipToBoundsRRect, SkClipOp::kIntersect, true);
+        } else {
+            canvas->clipRect(
+                SkRect::MakeXYWH(0, 0, _layout.width, _layout.height),
+                SkClipOp::kIntersect,
+                true);
         }
     }
 
-    return false;
+    auto op = _style.invertClip.has_value() && _style.invertClip.value() ? SkClipOp::kDifference : SkClipOp::kIntersect;
+    if (_clipPath.has_value()) {
+        canvas->clipPath(*_clipPath, op, true);
+    } else if (_clipRect.has_value()) {
+        canvas->clipRect(*_clipRect, op, true);
+    } else if (_clipRRect.has_value()) {
+        canvas->clipRRect(*_clipRRect, op, true);
+    }
 }
 
-jsi::Value YogaNode::getChildren(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count)
+SkPaint YogaNode::resolveDrawPaint(const sk_sp<SkMaskFilter>& maskFilter) const
 {
-    return withJsiError(runtime, "YogaNode.getChildren()", [&]() -> jsi::Value {
-        (void)thisArg;
-        (void)args;
-        (void)count;
-        jsi::Array arr = jsi::Array(runtime, _children.size());
-        for (size_t i = 0; i < _children.size(); ++i) {
-            auto obj = _children[i]->toObject(runtime);
-            arr.setValueAtIndex(runtime, i, obj);
+    auto paint = _paint;
+    // Command-specific text color is only used when the current style snapshot
+    // did not supply its own paint color. Style still wins when it is explicit.
+    if (!_style.backgroundColor.has_value()) {
+        if (const auto fallbackColor = _command->fallbackPaintColor()) {
+            if (_style.opacity.has_value()) {
+                paint.setColor(SkColorSetA(*fallbackColor, SkColorGetA(paint.getColor())));
+            } else {
+                paint.setColor(*fallbackColor);
+            }
         }
-        return arr;
-    });
+    }
+
+    paint.setMaskFilter(maskFilter);
+    return paint;
 }
 
-void YogaNode::computeLayout(std::optional<double> width, std::optional<double> height)
+// Rasterized groups keep their own cache, mask filters change the paint their
+// descendants inherit, and text shifts the canvas for its children during
+// draw. Those subtrees are drawn recursively instead of being flattened.
+bool YogaNode::flattensIntoDisplayList() const
 {
-    std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
-    float w = width.has_value() ? toFiniteYogaNodeMethodFloat(width.value(), "computeLayout.width") : YGUndefined;
-    float h = height.has_value() ? toFiniteYogaNodeMethodFloat(height.value(), "computeLayout.height") : YGUndefined;
-
-    YGNodeCalculateLayout(_node, w, h, YGDirectionInherit);
+    if (_command->rasterizesSubtree()) {
+        return false;
+    }
+
+    switch (_commandKind) {
+    case YogaNodeCommandKind::BLUR_MASK_FILTER:
+        return false;
+    case YogaNodeCommandKind::TEXT:
+        return _children.empty();
+    default:
+        return true;
+    }
+}
+
+std::optional<SkRect> YogaNodeCommand::localDrawBounds() const
+{
+    return SkRect::MakeWH(node->_layout.width, node->_layout.height);
+}
+
+bool YogaNode::updateSubtreeStatic()
+{
+    // Static-ness only changes with a command, which dirties the path to the
+    // root, so a clean subtree keeps its last answer.
+    if (!_paintDirty) {
+        return _subtreeStatic;
+    }
+
+    // Rasterized groups stay out of pictures so their images remain owned by
+    // the budgeted raster cache instead of being pinned by a recording.
+    _subtreeStatic = !_command->isDynamic() && !_command->rasterizesSubtree();
+    for (const auto& child : _children) {
+        if (child->_command && !child->updateSubtreeStatic()) {
+            _subtreeStatic = false;
+        }
+    }
+    return _subtreeStatic;
+}
+
+// Records the subtree on first use and keeps the picture until
+// invalidateRasterCache or a layout move drops it. The picture is bounded by the
+// subtree's cull bounds and carries an R-tree, so replaying it, directly or
+// nested in a snapshot, only draws the ops under the clip.
+const sk_sp<SkPicture>& YogaNode::ensurePictureCache()
+{
+    if (_pictureCache == nullptr) {
+        SkRTreeFactory bboxFactory;
+        SkPictureRecorder pictureRecorder;
+        const auto bounds = _cullBounds.value_or(kSubtreePictureBounds);
+        auto canvas = pictureRecorder.beginRecording(bounds, &bboxFactory);
+        RNSkia::DrawingCtx ctx(canvas);
+        drawInternal(ctx);
+        _pictureCache = pictureRecorder.finishRecordingAsPicture();
+    }
+    return _pictureCache;
+}
+
+void YogaNode::compileDisplayList(
+    std::vector<YogaDisplayListOp>& ops,
+    const SkMatrix& parentMatrix,
+    YogaDisplayListCompile& compile,
+    bool isListRoot)
+{
+    if (!isListRoot && spliceDisplayListOps(ops, parentMatrix, compile)) {
+        return;
+    }
+
+    const auto begin = ops.size();
+    appendDisplayListOps(ops, parentMatrix, compile, isListRoot);
+    _displayListOwner = compile.listRoot;
+    _displayListGeneration = compile.generation;
+    _displayListBegin = begin;
+    _displayListCount = ops.size() - begin;
+    _displayListParentMatrix = parentMatrix;
+}
+
+// Moves a clean subtree's ops over from the previous list. Its ops only depend
+// on the subtree, which paint-dirty bits cover, and on the parent matrix baked
+// into them. Every node whose ops start in the moved range is re-pointed at
+// the new list so it can be spliced again next time.
+bool YogaNode::spliceDisplayListOps(
+    std::vector<YogaDisplayListOp>& ops,
+    const SkMatrix& parentMatrix,
+    YogaDisplayListCompile& compile)
+{
+    auto& previousOps = compile.previousOps;
+    if (_paintDirty ||
+        compile.previousGeneration == 0 ||
+        _displayListOwner != compile.listRoot ||
+        _displayListGeneration != compile.previousGeneration ||
+        _displayListParentMatrix != parentMatrix ||
+        _displayListBegin + _displayListCount > previousOps.size()) {
+        return false;
+    }
+
+    const auto previousBegin = _displayListBegin;
+    const auto previousEnd = previousBegin + _displayListCount;
+    const auto begin = ops.size();
+    for (size_t index = previousBegin; index < previousEnd; ++index) {
+        auto& op = previousOps[index];
+        const auto newIndex = begin + (index - previousBegin);
+        auto* node = op.node;
+        if (node->_displayListOwner == compile.listRoot &&
+            node->_displayListGeneration == compile.previousGeneration &&
+            node->_displayListBegin == index) {
+            node->_displayListGeneration = compile.generation;
+            node->_displayListBegin = newIndex;
+        }
+        if (op.kind == YogaDisplayListOpKind::SAVE || op.kind == YogaDisplayListOpKind::SAVE_LAYER) {
+            op.restoreIndex = op.restoreIndex - index + newIndex;
+        }
+        ops.push_back(std::move(op));
+    }
+    return true;
+}
+
+void YogaNode::appendDisplayListOps(
+    std::vector<YogaDisplayListOp>& ops,
+    const SkMatrix& parentMatrix,
+    YogaDisplayListCompile& compile,
+    bool isListRoot)
+{
+    const auto& maskFilter = compile.maskFilter;
+    // Compilation stops at the outermost static subtree holding more than one
+    // node, unless it is the list's root or too large for one picture. An
+    // inherited mask filter would be baked into the picture, so those subtrees
+    // stay flattened.
+    std::optional<SkRect> cullBounds;
+    if (_cullBounds.has_value()) {
+        cullBounds = parentMatrix.mapRect(*_cullBounds);
+    }
+
+    if (_subtreeStatic && !_children.empty() && maskFilter == nullptr && !isListRoot &&
+        _subtreeNodeCount <= kMaxSubtreePictureNodes) {
+        ops.push_back({ YogaDisplayListOpKind::PICTURE, this, parentMatrix, SkPaint(), cullBounds });
+        return;
+    }
+
+    if (!flattensIntoDisplayList()) {
+        ops.push_back({ YogaDisplayListOpKind::DELEGATE, this, parentMatrix, SkPaint(), cullBounds });
+        return;
+    }
+
+    const auto matrix = localToParentMatrix(parentMatrix);
+    const bool hasClip = _clipsToBounds || _clipPath.has_value() || _clipRect.has_value() || _clipRRect.has_value();
+    const bool needsSave = hasClip || _layerPaint.has_value();
+    const auto saveIndex = ops.size();
+    if (needsSave) {
+        const auto kind = _layerPaint.has_value() ? YogaDisplayListOpKind::SAVE_LAYER : YogaDisplayListOpKind::SAVE;
+        ops.push_back({ kind, this, matrix, SkPaint(), cullBounds });
+    }
+
+    ops.push_back({ YogaDisplayListOpKind::DRAW, this, matrix, resolveDrawPaint(maskFilter), cullBounds });
+
+    for (const auto& child : _children) {
+        if (child->_command) {
+            child->compileDisplayList(ops, matrix, compile, false);
+        }
+    }
+
+    if (needsSave) {
+        ops[saveIndex].restoreIndex = ops.size();
+        ops.push_back({ YogaDisplayListOpKind::RESTORE, this, matrix, SkPaint(), std::nullopt });
+    }
+}
+
+SkMatrix YogaNode::localToParentMatrix(const SkMatrix& parentMatrix) const
+{
+    auto matrix = parentMatrix;
+    matrix.preTranslate(_layout.left, _layout.top);
+    if (_matrix) {
+        matrix.preConcat(*_matrix);
+    }
+    return matrix;
+}
+
+// Draws the subtree from its compiled display list. The list is recompiled only
+// when the subtree is paint dirty, which every style, command, structure and
+// layout change propagates up to here; steady frames just replay it. A
+// recompile only compiles dirty subtrees and splices the rest in from the
+// previous list. Ops whose subtree bounds miss the canvas clip are skipped,
+// whole SAVE ranges at once.
+void YogaNode::drawDisplayList(RNSkia::DrawingCtx& ctx)
+{
+    if (!_command) {
+        return;
+    }
+
+    auto maskFilter = ctx.getPaint().refMaskFilter();
+    if (!_displayListCompiled || _paintDirty || _displayListMaskFilter != maskFilter) {
+        // Paints bake in the mask filter, so changing it compiles everything.
+        const bool reusable = _displayListCompiled && _displayListMaskFilter == maskFilter;
+        YogaDisplayListCompile compile {
+            .listRoot = this,
+            .previousOps = std::move(_displayList),
+            .previousGeneration = reusable ? _displayListCompileGeneration : 0,
+            .generation = sDisplayListGeneration.fetch_add(1, std::memory_order_relaxed) + 1,
+            .maskFilter = maskFilter,
+        };
+        _displayList.clear();
+        _displayList.reserve(compile.previousOps.size());
+        // Left unset until the compile finishes, so a throw never lets the
+        // next one splice from a half-built list.
+        _displayListCompiled = false;
+        updateSubtreeStatic();
+        updateCullBounds(false);
+        compileDisplayList(_displayList, SkMatrix::I(), compile, true);
+        _displayListCompileGeneration = compile.generation;
+        _displayListMaskFilter = std::move(maskFilter);
+        _displayListCompiled = true;
+    }
+
+    auto* canvas = ctx.canvas;
+    const auto baseMatrix = canvas->getTotalMatrix();
+    const auto saveCount = canvas->save();
+
+    // Op bounds live in the list's root space; bring the clip there once.
+    SkMatrix inverseBaseMatrix;
+    std::optional<SkRect> clipBounds;
+    if (baseMatrix.invert(&inverseBaseMatrix)) {
+        clipBounds = inverseBaseMatrix.mapRect(SkRect::Make(canvas->getDeviceClipBounds()));
+    }
+
+    for (size_t index = 0; index < _displayList.size(); ++index) {
+        auto& op = _displayList[index];
+        if (clipBounds.has_value() && op.cullBounds.has_value() && !SkRect::Intersects(*op.cullBounds, *clipBounds)) {
+            switch (op.kind) {
+            case YogaDisplayListOpKind::SAVE:
+            case YogaDisplayListOpKind::SAVE_LAYER:
+                sCulledNodeCount += op.node->_subtreeNodeCount;
+                index = op.restoreIndex;
+                break;
+            case YogaDisplayListOpKind::DELEGATE:
+            case YogaDisplayListOpKind::PICTURE:
+                sCulledNodeCount += op.node->_subtreeNodeCount;
+                break;
+            default:
+                sCulledNodeCount += 1;
+                break;
+            }
+            continue;
+        }
+
+        switch (op.kind) {
+        case YogaDisplayListOpKind::SAVE:
+            canvas->save();
+            canvas->setMatrix(SkMatrix::Concat(baseMatrix, op.matrix));
+            op.node->applyClips(canvas);
+            break;
+        case YogaDisplayListOpKind::SAVE_LAYER:
+            canvas->saveLayer(nullptr, &op.node->_layerPaint.value());
+            canvas->setMatrix(SkMatrix::Concat(baseMatrix, op.matrix));
+            op.node->applyClips(canvas);
+            break;
+        case YogaDisplayListOpKind::DRAW:
+            canvas->setMatrix(SkMatrix::Concat(baseMatrix, op.matrix));
+            ctx.pushPaint(op.paint);
+            op.node->_command->draw(&ctx);
+            ctx.restorePaint();
+            break;
+        case YogaDisplayListOpKind::DELEGATE:
+            canvas->setMatrix(SkMatrix::Concat(baseMatrix, op.matrix));
+            op.node->drawInternal(ctx);
+            break;
+        case YogaDisplayListOpKind::PICTURE:
+            canvas->setMatrix(SkMatrix::Concat(baseMatrix, op.matrix));
+            canvas->drawPicture(op.node->ensurePictureCache());
+            break;
+        case YogaDisplayListOpKind::RESTORE:
+            canvas->restore();
+            break;
+        }
+    }
+
+    canvas->restoreToCount(saveCount);
+}
+
+// Returns the device-space area whose pixels changed since the previous call,
+// given the matrix the renderer draws the root with. Only subtrees with pending
+// damage or animated content are visited; everything else keeps its bounds.
+SkRect YogaNode::collectDamage(const SkMatrix& baseMatrix)
+{
+    YogaTreeLock lock(*this);
+
+    auto damage = SkRect::MakeEmpty();
+    if (!_command) {
+        return damage;
+    }
+
+    updateLayout();
+
+    // Bounds are stored in the renderer's device space, so a new base matrix
+    // (pixel density change) recomputes them all.
+    if (baseMatrix != _damageBaseMatrix) {
+        _damageBaseMatrix = baseMatrix;
+        _selfDamaged = true;
+    }
+
+    accumulateDamage(baseMatrix, false, damage);
+    return damage;
+}
+
+// Layout bounds of every node plus command-specific debug geometry. Drawn by
+// the renderer straight onto the presented canvas when the view shows debug
+// overlays, so nothing debug-only reaches the display list or any cache.
+void YogaNode::drawDebugOverlay(SkCanvas* canvas)
+{
+    YogaTreeLock lock(*this);
+
+    SkPaint boundsPaint;
+    boundsPaint.setStyle(SkPaint::kStroke_Style);
+    boundsPaint.setStrokeWidth(0.0f);
+    boundsPaint.setColor(SkColorSetARGB(160, 125, 211, 252));
+    drawDebugOverlayInternal(canvas, boundsPaint);
+}
+
+void YogaNode::drawDebugOverlayInternal(SkCanvas* canvas, const SkPaint& boundsPaint) const
+{
+    canvas->save();
+    canvas->concat(localToParentMatrix(SkMatrix::I()));
+    canvas->drawRect(SkRect::MakeWH(_layout.width, _layout.height), boundsPaint);
+    if (_command) {
+        _command->drawDebugOverlay(canvas);
+    }
+
+    for (const auto& child : _children) {
+        child->drawDebugOverlayInternal(canvas, boundsPaint);
+    }
+    canvas->restore();
+}
+
+void YogaNode::accumulateDamage(const SkMatrix& parentMatrix, bool inheritsMaskFilter, SkRect& damage)
+{
+    if (_selfDamaged || _command->isDynamic()) {
+        if (_hasDeviceBounds) {
+            damage.join(_deviceBounds);
+        }
+        updateDeviceBounds(parentMatrix, inheritsMaskFilter);
+        damage.join(_deviceBounds);
+        return;
+    }
+
+    const auto matrix = localToParentMatrix(parentMatrix);
+    const bool childInheritsMaskFilter = inheritsMaskFilter || _commandKind == YogaNodeCommandKind::BLUR_MASK_FILTER;
+    for (const auto& child : _children) {
+        if (child->_command && (child->_damagePending || !child->_subtreeStatic)) {
+            child->accumulateDamage(matrix, childInheritsMaskFilter, damage);
+        }
+    }
+
+    _damagePending = false;
+    joinDeviceBounds(matrix, inheritsMaskFilter);
+}
+
+void YogaNode::updateDeviceBounds(const SkMatrix& parentMatrix, bool inheritsMaskFilter)
+{
+    const auto matrix = localToParentMatrix(parentMatrix);
+    const bool childInheritsMaskFilter = inheritsMaskFilter || _commandKind == YogaNodeCommandKind::BLUR_MASK_FILTER;
+    for (const auto& child : _children) {
+        if (child->_command) {
+            child->updateDeviceBounds(matrix, childInheritsMaskFilter);
+        }
+    }
+
+    _selfDamaged = false;
+    _damagePending = false;
+    joinDeviceBounds(matrix, inheritsMaskFilter);
+}
+
+// Combines the node's own drawing with its children's stored bounds. Anything
+// whose extent cannot be bounded (unknown geometry, inherited blur, image
+// filters) becomes kUnboundedDeviceRect.
+void YogaNode::joinDeviceBounds(const SkMatrix& matrix, bool inheritsMaskFilter)
+{
+    auto bounds = kUnboundedDeviceRect;
+    if (const auto localBounds = ownLocalBounds(inheritsMaskFilter)) {
+        bounds = matrix.mapRect(*localBounds);
+    }
+
+    for (const auto& child : _children) {
+        if (child->_command && child->_hasDeviceBounds) {
+            bounds.join(child->_deviceBounds);
+        }
+    }
+
+    if (_clipsToBounds) {
+        auto clipBounds = matrix.mapRect(SkRect::MakeWH(_layout.width, _layout.height));
+        clipBounds.outset(1.0f, 1.0f);
+        if (!bounds.intersect(clipBounds)) {
+            bounds.setEmpty();
+        }
+    }
+
+    if (_layerPaint.has_value() && _layerPaint->getImageFilter() != nullptr) {
+        bounds = kUnboundedDeviceRect;
+    }
+
+    _deviceBounds = bounds;
+    _hasDeviceBounds = true;
+}
+
+// The node's own drawing in local space, outset by its paint (stroke, mask
+// filter) and a pixel of antialiasing. nullopt when it cannot be bounded.
+std::optional<SkRect> YogaNode::ownLocalBounds(bool inheritsMaskFilter) const
+{
+    if (inheritsMaskFilter || !_paint.canComputeFastBounds()) {
+        return std::nullopt;
+    }
+
+    const auto localBounds = _command->localDrawBounds();
+    if (!localBounds.has_value()) {
+        return std::nullopt;
+    }
+
+    SkRect storage;
+    auto bounds = _paint.computeFastBounds(*localBounds, &storage);
+    bounds.outset(1.0f, 1.0f);
+    return bounds;
+}
+
+// Refreshes the subtree bounds used for clip culling, in the parent's
+// coordinate space so they include this node's offset, matrix and any
+// overflowing children. Only paint-dirty paths are revisited. Animated
+// commands are left unbounded because their extent changes without a commit.
+void YogaNode::updateCullBounds(bool inheritsMaskFilter)
+{
+    if (!_paintDirty && _hasCullBounds) {
+        return;
+    }
+
+    std::optional<SkRect> bounds;
+    if (!_command->isDynamic()) {
+        bounds = ownLocalBounds(inheritsMaskFilter);
+    }
+
+    const bool childInheritsMaskFilter = inheritsMaskFilter || _commandKind == YogaNodeCommandKind::BLUR_MASK_FILTER;
+    _subtreeNodeCount = 1;
+    for (const auto& child : _children) {
+        if (!child->_command) {
+            continue;
+        }
+        child->updateCullBounds(childInheritsMaskFilter);
+        _subtreeNodeCount += child->_subtreeNodeCount;
+        if (bounds.has_value()) {
+            if (child->_cullBounds.has_value()) {
+                bounds->join(*child->_cullBounds);
+            } else {
+                bounds.reset();
+            }
+        }
+    }
+
+    if (_clipsToBounds) {
+        auto clipBounds = SkRect::MakeWH(_layout.width, _layout.height);
+        clipBounds.outset(1.0f, 1.0f);
+        if (!bounds.has_value()) {
+            bounds = clipBounds;
+        } else if (!bounds->intersect(clipBounds)) {
+            bounds->setEmpty();
+        }
+    }
+
+    if (_layerPaint.has_value() && _layerPaint->getImageFilter() != nullptr) {
+        bounds.reset();
+    }
+
+    _cullBounds.reset();
+    if (bounds.has_value()) {
+        _cullBounds = localToParentMatrix(SkMatrix::I()).mapRect(*bounds);
+    }
+    _hasCullBounds = true;
+}
+
+bool YogaNode::isOutsideClip(const SkRect& localClipBounds) const
+{
+    return _hasCullBounds && _cullBounds.has_value() && !SkRect::Intersects(*_cullBounds, localClipBounds);
+}
+
+size_t YogaNode::consumeCulledNodeCount()
+{
+    return std::exchange(sCulledNodeCount, 0);
+}
+
+bool YogaNode::subtreeHasDynamicRasterContent() const
+{
+    if (_command && _command->isDynamic()) {
+        return true;
+    }
+
+    for (const auto& child : _children) {
+        if (child->subtreeHasDynamicRasterContent()) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+std::shared_ptr<std::recursive_mutex> YogaNode::treeMutex() const
+{
+    std::lock_guard<std::mutex> guard(_treeMutexGuard);
+    return _treeMutex;
+}
+
+// Called with the old tree locked; moves the whole subtree to another tree.
+void YogaNode::adoptTreeMutex(const std::shared_ptr<std::recursive_mutex>& mutex)
+{
+    {
+        std::lock_guard<std::mutex> guard(_treeMutexGuard);
+        if (_treeMutex == mutex) {
+            return;
+        }
+        _treeMutex = mutex;
+    }
+
+    for (const auto& child : _children) {
+        child->adoptTreeMutex(mutex);
+    }
+}
+
+void YogaNode::collectAnimatedCells(std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells)
+{
+    _animatedCellsDirty = false;
+
+    if (_command) {
+        _command->collectAnimatedCells(cells);
+    }
+
+    for (const auto& child : _children) {
+        child->collectAnimatedCells(cells);
+    }
+}
+
+void YogaNode::invalidateAnimatedCells()
+{
+    if (_animatedCellsDirty) {
+        return;
+    }
+    _animatedCellsDirty = true;
+
+    if (auto parent = _parent.lock()) {
+        parent->invalidateAnimatedCells();
+    }
+}
+
+// The batch of animated cells is cached on whichever node acts as the render
+// root and rebuilt only after command or structure changes. Each frame samples
+// the whole batch once, then publishes it, so every command reads the same
+// frame-local snapshot.
+void YogaNode::sampleAnimatedValues()
+{
+    YogaTreeLock lock(*this);
+
+    if (_animatedCellsDirty) {
+        _animatedCells.clear();
+        collectAnimatedCells(_animatedCells);
+
+        // Cells are shared per synchronizable; sample each one once a frame.
+        std::sort(_animatedCells.begin(), _animatedCells.end());
+        _animatedCells.erase(std::unique(_animatedCells.begin(), _animatedCells.end()), _animatedCells.end());
+    }
+
+    sampleAnimatedDoubleCells(_animatedCells);
+}
+
+jsi::Value YogaNode::getChildren(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count)
+{
+    return withJsiError(runtime, "YogaNode.getChildren()", [&]() -> jsi::Value {
+        (void)thisArg;
+        (void)args;
+        (void)count;
+        jsi::Array arr = jsi::Array(runtime, _children.size());
+        for (size_t i = 0; i < _children.size(); ++i) {
+            auto obj = _children[i]->toObject(runtime);
+            arr.setValueAtIndex(runtime, i, obj);
+        }
+        return arr;
+    });
+}
+
+void YogaNode::computeLayout(std::optional<double> width, std::optional<double> height)
+{
+    YogaTreeLock lock(*this);
+    float w = width.has_value() ? toFiniteYogaNodeMethodFloat(width.value(), "computeLayout.width") : YGUndefined;
+    float h = height.has_value() ? toFiniteYogaNodeMethodFloat(height.value(), "computeLayout.height") : YGUndefined;
+
+    YGNodeCalculateLayout(_node, w, h, YGDirectionInherit);
     recursiveSetLayout();
 }
 
+// The layout phase of a frame. Dirty bits reach the root, so one Yoga pass
+// from here settles the whole tree and drawing never has to run Yoga.
+bool YogaNode::updateLayout()
+{
+    YogaTreeLock lock(*this);
+    // Layout is only valid when computed from the root, so forward there.
+    if (auto parent = _parent.lock()) {
+        auto root = std::move(parent);
+        while (auto next = root->_parent.lock()) {
+            root = std::move(next);
+        }
+        return root->updateLayout();
+    }
+
+    if (!_layoutDirty) {
+        return false;
+    }
+
+    computeLayout(std::nullopt, std::nullopt);
+    return true;
+}
+
+void YogaNode::setRenderRequestCallback(std::function<void()> callback)
+{
+    std::lock_guard<std::mutex> lock(_renderRequestMutex);
+    _renderRequestCallback = std::move(callback);
+}
+
+// Called without the tree lock, possibly from a shaping worker. The callback
+// only posts the request; the view records its snapshot on the JS thread.
+void YogaNode::requestRender()
+{
+    std::function<void()> callback;
+    {
+        std::lock_guard<std::mutex> lock(_renderRequestMutex);
+        callback = _renderRequestCallback;
+    }
+
+    if (callback) {
+        callback();
+    }
+}
+
+// Yoga flags every node it laid out during the last calculation. A node it
+// did not visit has an untouched subtree, so propagation stops there.
 void YogaNode::recursiveSetLayout()
 {
+    if (!YGNodeGetHasNewLayout(_node)) {
+        settleLayoutDirty();
+        return;
+    }
+    YGNodeSetHasNewLayout(_node, false);
+
+    const auto previousLayout = _layout;
     _layout.left = YGNodeLayoutGetLeft(_node);
     _layout.right = YGNodeLayoutGetRight(_node);
     _layout.width = YGNodeLayoutGetWidth(_node);
     _layout.height = YGNodeLayoutGetHeight(_node);
     _layout.top = YGNodeLayoutGetTop(_node);
     _layout.bottom = YGNodeLayoutGetBottom(_node);
+    // Compiled display lists and ancestor raster caches bake in positions, so a
+    // node that moved or resized repaints even without a style change. Only a
+    // size change invalidates the node's own raster cache.
+    if (_layout.width != previousLayout.width || _layout.height != previousLayout.height) {
+        updateClipGeometry();
+        invalidateRasterCache();
+        markHitTestIndexDirty();
+    } else if (_layout.left != previousLayout.left || _layout.top != previousLayout.top) {
+        _selfDamaged = true;
+        _pictureCache.reset();
+        _paintDirty = true;
+        markDamagePending();
+        markHitTestIndexDirty();
+        if (auto parent = _parent.lock()) {
+            parent->invalidatePaint();
+        }
+    }
     if (_command) {
         _command->setLayout(_layout);
     }
-    _hasLayoutBeenComputed = true;
+    _layoutDirty = false;
 
     for (const auto& child : _children) {
         child->recursiveSetLayout();
     }
 }
 
+// Clears layout dirty bits inside a subtree Yoga left alone. Marked commands
+// still get their layout re-applied, as their own props may have changed.
+void YogaNode::settleLayoutDirty()
+{
+    if (!_layoutDirty) {
+        return;
+    }
+    _layoutDirty = false;
+
+    if (_command) {
+        _command->setLayout(_layout);
+    }
+
+    for (const auto& child : _children) {
+        child->settleLayoutDirty();
+    }
+}
+
+// Dirty bits keep the invariant that every ancestor of a dirty node is dirty
+// too, so propagation can stop at the first node that is already marked.
 void YogaNode::invalidateLayout()
 {
-    _hasLayoutBeenComputed = false;
-    _rasterCacheDirty = true;
-    _rasterCache.reset();
+    invalidateRasterCache();
+    markLayoutDirty();
+}
+
+void YogaNode::markLayoutDirty()
+{
+    if (_layoutDirty) {
+        return;
+    }
+    _layoutDirty = true;
+
     if (auto parent = _parent.lock()) {
-        parent->invalidateLayout();
+        parent->markLayoutDirty();
     }
 }
 
+// The node's own output changed: its area is damaged and every cache that
+// contains it is dropped.
 void YogaNode::invalidateRasterCache()
 {
+    _selfDamaged = true;
+    invalidatePaint();
+}
+
+void YogaNode::invalidatePaint()
+{
+    if (!_rasterCacheDirty) {
+        RasterCacheManager::shared().erase(this);
+    }
     _rasterCacheDirty = true;
-    _rasterCache.reset();
+    _pictureCache.reset();
+    markDamagePending();
+
+    if (_paintDirty) {
+        return;
+    }
+    _paintDirty = true;
+
+    if (auto parent = _parent.lock()) {
+        parent->invalidatePaint();
+    }
+}
+
+void YogaNode::markDamagePending()
+{
+    if (_damagePending) {
+        return;
+    }
+    _damagePending = true;
 
     if (auto parent = _parent.lock()) {
-        parent->invalidateRasterCache();
+        parent->markDamagePending();
+    }
+}
+
+void YogaNode::clearPaintDirty()
+{
+    if (!_paintDirty) {
+        return;
+    }
+    _paintDirty = false;
+
+    for (const auto& child : _children) {
+        child->clearPaintDirty();
     }
 }
 
@@ -1970,12 +3117,11 @@ void YogaNode::updateSelfInteractionState(bool isInteractive)
 bool YogaNode::pointPassesClipping(const ::SkPoint& point) const
 {
     if (_clipsToBounds) {
-        const auto bounds = SkRect::MakeXYWH(0.0f, 0.0f, _layout.width, _layout.height);
-        if (_clipToBoundsRadii.has_value()) {
-            if (!detail::pointInRoundedRect(point, bounds, *_clipToBoundsRadii)) {
+        if (_clipToBoundsRRect.has_value()) {
+            if (!detail::pointInRoundedRect(point, *_clipToBoundsRRect)) {
                 return false;
             }
-        } else if (!bounds.contains(point.fX, point.fY)) {
+        } else if (!SkRect::MakeWH(_layout.width, _layout.height).contains(point.fX, point.fY)) {
             return false;
         }
     }
@@ -1988,10 +3134,9 @@ bool YogaNode::pointPassesClipping(const ::SkPoint& point) const
     } else if (_clipRect.has_value()) {
         hasExplicitClip = true;
         explicitClipContains = _clipRect->contains(point.fX, point.fY);
-    } else if (_clipRRect.has_value()) {
+    } else if (_clipRRectPath.has_value()) {
         hasExplicitClip = true;
-        const auto clipPath = detail::makePath(*_clipRRect);
-        explicitClipContains = clipPath.contains(point.fX, point.fY);
+        explicitClipContains = _clipRRectPath->contains(point.fX, point.fY);
     }
 
     if (hasExplicitClip && _style.invertClip.value_or(false)) {
@@ -2029,12 +3174,11 @@ double YogaNode::hitTestInternal(const ::SkPoint& parentPoint) const
     auto localPoint = parentPoint;
     localPoint.offset(-static_cast<float>(_layout.left), -static_cast<float>(_layout.top));
 
-    if (_matrix != nullptr) {
-        SkMatrix inverse;
-        if (!_matrix->invert(&inverse)) {
+    if (_matrix.has_value()) {
+        if (!_inverseMatrix.has_value()) {
             return 0.0;
         }
-        localPoint = inverse.mapPoint(localPoint);
+        localPoint = _inverseMatrix->mapPoint(localPoint);
     }
 
     if (!pointPassesClipping(localPoint)) {
@@ -2058,17 +3202,160 @@ double YogaNode::hitTestInternal(const ::SkPoint& parentPoint) const
 
 double YogaNode::hitTestTagAt(float x, float y)
 {
-    if (!_hasLayoutBeenComputed) {
-        computeLayout(std::nullopt, std::nullopt);
+    updateLayout();
+
+    const auto point = ::SkPoint::Make(x, y);
+    if (usesHitTestIndex()) {
+        return hitTestIndexed(point);
+    }
+
+    return hitTestInternal(point);
+}
+
+bool YogaNode::usesHitTestIndex() const
+{
+    return _parent.expired() && _interactiveDescendantCount >= kHitTestIndexMinNodes;
+}
+
+// Same result as hitTestInternal: candidates are tried topmost first and each
+// one runs the exact containment and ancestor clip checks of the tree walk.
+double YogaNode::hitTestIndexed(const ::SkPoint& point)
+{
+    if (_hitTestIndex == nullptr || _hitTestIndexDirty) {
+        auto index = std::make_unique<YogaHitTestIndex>();
+        buildHitTestIndex(*index, SkMatrix::I(), -1);
+
+        for (const auto& entry : index->entries) {
+            index->bounds.join(entry.bounds);
+        }
+
+        const auto side = static_cast<int>(std::ceil(std::sqrt(static_cast<double>(index->entries.size()))));
+        index->columns = std::clamp(side, 1, kHitTestGridMaxCells);
+        index->rows = index->columns;
+        index->cellWidth = std::max(index->bounds.width() / index->columns, 1.0f);
+        index->cellHeight = std::max(index->bounds.height() / index->rows, 1.0f);
+        index->cells.resize(static_cast<size_t>(index->columns) * index->rows);
+
+        const auto cellColumn = [&](float x) {
+            return std::clamp(static_cast<int>((x - index->bounds.left()) / index->cellWidth), 0, index->columns - 1);
+        };
+        const auto cellRow = [&](float y) {
+            return std::clamp(static_cast<int>((y - index->bounds.top()) / index->cellHeight), 0, index->rows - 1);
+        };
+
+        for (uint32_t entryIndex = 0; entryIndex < index->entries.size(); ++entryIndex) {
+            const auto& bounds = index->entries[entryIndex].bounds;
+            for (auto row = cellRow(bounds.top()); row <= cellRow(bounds.bottom()); ++row) {
+                for (auto column = cellColumn(bounds.left()); column <= cellColumn(bounds.right()); ++column) {
+                    index->cells[static_cast<size_t>(row) * index->columns + column].push_back(entryIndex);
+                }
+            }
+        }
+
+        _hitTestIndex = std::move(index);
+        clearHitTestIndexDirty();
+    }
+
+    const auto& index = *_hitTestIndex;
+    if (!index.bounds.contains(point.fX, point.fY)) {
+        return 0.0;
+    }
+
+    const auto column = std::min(static_cast<int>((point.fX - index.bounds.left()) / index.cellWidth), index.columns - 1);
+    const auto row = std::min(static_cast<int>((point.fY - index.bounds.top()) / index.cellHeight), index.rows - 1);
+    const auto& cell = index.cells[static_cast<size_t>(row) * index.columns + column];
+
+    for (auto it = cell.rbegin(); it != cell.rend(); ++it) {
+        const auto& entry = index.entries[*it];
+        if (!entry.bounds.contains(point.fX, point.fY) ||
+            !entry.node->containsSelfAtPoint(entry.inverseMatrix.mapPoint(point))) {
+            continue;
+        }
+
+        auto passesClips = true;
+        for (auto clip = entry.clip; clip >= 0 && passesClips; clip = index.clips[clip].parent) {
+            const auto& clipEntry = index.clips[clip];
+            passesClips = clipEntry.node->pointPassesClipping(clipEntry.inverseMatrix.mapPoint(point));
+        }
+
+        if (passesClips) {
+            return entry.node->_eventTag;
+        }
+    }
+
+    return 0.0;
+}
+
+// Mirrors the pruning of hitTestInternal. Entries are appended in pre-order,
+// so children land after their parent and later siblings after earlier ones.
+void YogaNode::buildHitTestIndex(YogaHitTestIndex& index, const SkMatrix& parentMatrix, int32_t clip) const
+{
+    if (_interactiveDescendantCount == 0 || _pointerEvents == PointerEventsMode::NONE) {
+        return;
+    }
+
+    auto matrix = parentMatrix;
+    matrix.preTranslate(static_cast<float>(_layout.left), static_cast<float>(_layout.top));
+    if (_matrix.has_value()) {
+        matrix.preConcat(*_matrix);
+    }
+
+    SkMatrix inverse;
+    if (!matrix.invert(&inverse)) {
+        return;
+    }
+
+    if (_clipsToBounds || _clipPath.has_value() || _clipRect.has_value() || _clipRRect.has_value()) {
+        index.clips.push_back({ this, inverse, clip });
+        clip = static_cast<int32_t>(index.clips.size() - 1);
+    }
+
+    if (_pointerEvents != PointerEventsMode::BOX_NONE && _selfInteractive) {
+        auto bounds = matrix.mapRect(SkRect::MakeLTRB(
+            -_hitSlop.left,
+            -_hitSlop.top,
+            static_cast<float>(_layout.width) + _hitSlop.right,
+            static_cast<float>(_layout.height) + _hitSlop.bottom));
+        // Slack for rounding between the composed and per-level mappings.
+        bounds.outset(1.0f, 1.0f);
+        index.entries.push_back({ this, inverse, bounds, clip });
+    }
+
+    if (_pointerEvents != PointerEventsMode::BOX_ONLY) {
+        for (const auto& child : _children) {
+            child->buildHitTestIndex(index, matrix, clip);
+        }
+    }
+}
+
+void YogaNode::markHitTestIndexDirty()
+{
+    if (_hitTestIndexDirty) {
+        return;
+    }
+    _hitTestIndexDirty = true;
+
+    if (auto parent = _parent.lock()) {
+        parent->markHitTestIndexDirty();
+    }
+}
+
+void YogaNode::clearHitTestIndexDirty()
+{
+    if (!_hitTestIndexDirty) {
+        return;
     }
+    _hitTestIndexDirty = false;
 
-    return hitTestInternal(::SkPoint::Make(x, y));
+    for (const auto& child : _children) {
+        child->clearHitTestIndexDirty();
+    }
 }
 
 jsi::Value YogaNode::hitTest(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count)
 {
     return withJsiError(runtime, "YogaNode.hitTest(x, y)", [&]() -> jsi::Value {
-        std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
+        YogaTreeLock lock(*this);
         (void)thisArg;
 
         if (count < 2 || !args[0].isNumber() || !args[1].isNumber()) {
@@ -2081,10 +3368,70 @@ jsi::Value YogaNode::hitTest(jsi::Runtime& runtime, const jsi::Value& thisArg, c
     });
 }
 
+// Points arrive as interleaved x, y pairs. The tree lock is taken once and
+// roots answer from the hit-test index, whose cached inverse matrices are
+// shared by every point of the batch.
+jsi::Value YogaNode::hitTestMany(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count)
+{
+    return withJsiError(runtime, "YogaNode.hitTestMany(points)", [&]() -> jsi::Value {
+        YogaTreeLock lock(*this);
+        (void)thisArg;
+
+        if (count < 1 || !args[0].isObject()) {
+            throw jsi::JSError(runtime, "YogaNode.hitTestMany(points) expects a Float32Array of x, y pairs.");
+        }
+
+        const auto points = args[0].asObject(runtime);
+        // Other typed arrays share the buffer/byteOffset/length shape, so the
+        // element type is checked before the bytes are read as floats.
+        const auto bytesPerElement = points.getProperty(runtime, "BYTES_PER_ELEMENT");
+        const auto constructor = points.getProperty(runtime, "constructor");
+        const auto constructorName = constructor.isObject()
+            ? constructor.asObject(runtime).getProperty(runtime, "name")
+            : jsi::Value::undefined();
+        if (!bytesPerElement.isNumber() || bytesPerElement.asNumber() != sizeof(float) ||
+            !constructorName.isString() || constructorName.asString(runtime).utf8(runtime) != "Float32Array") {
+            throw jsi::JSError(runtime, "YogaNode.hitTestMany(points) expects a Float32Array of x, y pairs.");
+        }
+
+        const auto bufferValue = points.getProperty(runtime, "buffer");
+        if (!bufferValue.isObject() || !bufferValue.asObject(runtime).isArrayBuffer(runtime)) {
+            throw jsi::JSError(runtime, "YogaNode.hitTestMany(points) expects a Float32Array of x, y pairs.");
+        }
+
+        const auto buffer = bufferValue.asObject(runtime).getArrayBuffer(runtime);
+        const auto byteOffset = static_cast<size_t>(points.getProperty(runtime, "byteOffset").asNumber());
+        const auto length = static_cast<size_t>(points.getProperty(runtime, "length").asNumber());
+        if (length % 2 != 0 || byteOffset + length * sizeof(float) > buffer.size(runtime)) {
+            throw jsi::JSError(runtime, "YogaNode.hitTestMany(points) expects an even number of coordinates.");
+        }
+
+        std::vector<float> coordinates(length);
+        if (length > 0) {
+            std::memcpy(coordinates.data(), buffer.data(runtime) + byteOffset, length * sizeof(float));
+        }
+        for (const auto coordinate : coordinates) {
+            if (!std::isfinite(coordinate)) {
+                throwInvalidYogaNodeMethodNumber("hitTestMany.points");
+            }
+        }
+
+        updateLayout();
+
+        const auto useIndex = usesHitTestIndex();
+        jsi::Array tags(runtime, length / 2);
+        for (size_t index = 0; index < length / 2; ++index) {
+            const auto point = ::SkPoint::Make(coordinates[index * 2], coordinates[index * 2 + 1]);
+            tags.setValueAtIndex(runtime, index, useIndex ? hitTestIndexed(point) : hitTestInternal(point));
+        }
+        return tags;
+    });
+}
+
 jsi::Value YogaNode::setInteractionConfig(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count)
 {
     return withJsiError(runtime, "YogaNode.setInteractionConfig(config)", [&]() -> jsi::Value {
-        std::lock_guard<std::recursive_mutex> lock(yogaTreeMutex());
+        YogaTreeLock lock(*this);
         (void)thisArg;
 
         if (count < 1 || !args[0].isObject()) {
@@ -2152,6 +3499,7 @@ jsi::Value YogaNode::setInteractionConfig(jsi::Runtime& runtime, const jsi::Valu
         _preciseHit = preciseHit;
         _eventTag = nextEventTag;
         updateSelfInteractionState(_eventTag > 0.0);
+        markHitTestIndexDirty();
         return jsi::Value::undefined();
     });
 }
@@ -2185,6 +3533,13 @@ void TextCmd::updateProps(const TextCommandData& props)
     }
 
     _fallbackPaintColor = textStyle.getColor();
+
+    _textBounds.setEmpty();
+    if (const auto& textFont = this->props.font; textFont.has_value() && !this->props.text.empty()) {
+        textFont->measureText(
+            this->props.text.c_str(), this->props.text.size(), SkTextEncoding::kUTF8, &_textBounds);
+        _textBounds.offset(0, textFont->getSize());
+    }
 }
 
 void ImageCmd::updateProps(const ImageCommandData& props)
@@ -2227,10 +3582,23 @@ void PointsCmd::updateProps(const PointsCommandData& props)
     setLayout(node->_layout);
 }
 
-void ParagraphCmd::updateProps(const ParagraphCommandData& props)
+bool ParagraphCmd::updateProps(const ParagraphCommandData& props)
+{
+    const auto previousShaped = _shaped;
+    const auto previousPlaceholderHeight = _placeholderHeight;
+    applyProps(props);
+    return _shaped != previousShaped || (!_shaped && _placeholderHeight != previousPlaceholderHeight);
+}
+
+void ParagraphCmd::applyProps(const ParagraphCommandData& props)
 {
+    _shapingGeneration += 1;
+
     if (props.paragraph.has_value() && props.paragraph.value()) {
-        this->props.paragraph = props.paragraph.value();
+        auto shaped = std::make_shared<ShapedParagraph>();
+        shaped->paragraph = props.paragraph.value();
+        shaped->memoizesLayout = false;
+        setShaped(std::move(shaped));
         setLayout(node->_layout);
         return;
     }
@@ -2248,24 +3616,185 @@ void ParagraphCmd::updateProps(const ParagraphCommandData& props)
     }
     paragraphStyle.setTextStyle(textStyle);
 
-    auto context = GetPlatformContext();
-    auto fontCollection = sk_make_sp<para::FontCollection>();
-    auto fontMgr = RNSkia::JsiSkFontMgrFactory::getFontMgr(context);
-    fontCollection->setDefaultFontManager(fontMgr);
-    fontCollection->enableFontFallback();
+    auto text = props.text.value_or("");
+    if (auto shaped = ParagraphCache::shared().find(text, paragraphStyle)) {
+        setShaped(std::move(shaped));
+        setLayout(node->_layout);
+        return;
+    }
 
-    auto builder = para::ParagraphBuilder::make(paragraphStyle, fontCollection, makeUnicode());
-    if (!builder) {
+    if (!canShapeInBackground()) {
+        auto shaped = shapeParagraph(text, paragraphStyle);
+        if (!shaped) {
+            _placeholderHeight = 0.0f;
+            setLayout(node->_layout);
+            return;
+        }
+        ParagraphCache::shared().store(text, paragraphStyle, shaped);
+        setShaped(std::move(shaped));
+        setLayout(node->_layout);
         return;
     }
 
-    builder->pushStyle(paragraphStyle.getTextStyle());
-    const auto text = props.text.value_or("");
+    // A cache miss is shaped on the worker pool. The previous paragraph, if
+    // any, stays on screen until the result lands.
+    _placeholderHeight = textStyle.getFontSize() * kPlaceholderLineHeightScale;
+    setLayout(node->_layout);
+
+    std::weak_ptr<YogaNode> weakNode = node->shared_cast<YogaNode>();
+    const auto generation = _shapingGeneration;
+    ParagraphShapingPool::shared().submit([weakNode, generation, text = std::move(text), paragraphStyle]() {
+        std::shared_ptr<ShapedParagraph> shaped;
+        try {
+            shaped = shapeParagraph(text, paragraphStyle);
+        } catch (...) {
+            shaped.reset();
+        }
+        if (shaped) {
+            ParagraphCache::shared().store(text, paragraphStyle, shaped);
+        }
+        if (auto node = weakNode.lock()) {
+            finishShaping(node, generation, std::move(shaped));
+        }
+    });
+}
+
+std::shared_ptr<RNSkia::JsiSkParagraph> ParagraphCmd::buildParagraph(const std::string& text, const para::ParagraphStyle& style)
+{
+    auto builder = acquireParagraphBuilder(style);
+    if (!builder) {
+        return nullptr;
+    }
+
+    builder->pushStyle(style.getTextStyle());
     builder->addText(text.c_str(), text.size());
 
-    this->props.paragraph = std::make_shared<RNSkia::JsiSkParagraph>(context, builder.get());
-    this->props.paragraph->getObject()->layout(ParagraphCmd::kInitialParagraphLayoutWidth);
-    setLayout(node->_layout);
+    auto paragraph = std::make_shared<RNSkia::JsiSkParagraph>(GetPlatformContext(), builder.get());
+    releaseParagraphBuilder(style, std::move(builder));
+    return paragraph;
+}
+
+// Runs on a shaping worker. The first layout happens here as well, so the
+// measure pass that follows usually finds the paragraph laid out already.
+std::shared_ptr<ShapedParagraph> ParagraphCmd::shapeParagraph(const std::string& text, const para::ParagraphStyle& style)
+{
+    auto paragraph = buildParagraph(text, style);
+    if (!paragraph) {
+        return nullptr;
+    }
+
+    auto shaped = std::make_shared<ShapedParagraph>();
+    shaped->text = text;
+    shaped->style = style;
+    shaped->paragraph = std::move(paragraph);
+
+    std::lock_guard<std::mutex> lock(shaped->mutex);
+    layoutShapedParagraph(*shaped, ParagraphCmd::kInitialParagraphLayoutWidth);
+    return shaped;
+}
+
+// Hands a background result to its node unless newer props replaced the
+// text meanwhile and marks it dirty, then asks the view showing the tree for
+// a frame. The view republishes on the JS thread, never on this worker. A
+// null result means shaping failed: the node keeps its previous paragraph,
+// if any, and stops reserving a placeholder line.
+void ParagraphCmd::finishShaping(const std::shared_ptr<YogaNode>& node, uint64_t generation, std::shared_ptr<ShapedParagraph> shaped)
+{
+    std::shared_ptr<YogaNode> root;
+    {
+        YogaTreeLock lock(*node);
+        if (node->_commandKind != YogaNodeCommandKind::PARAGRAPH) {
+            return;
+        }
+        auto cmd = static_cast<ParagraphCmd*>(node->_command.get());
+        if (cmd->_shapingGeneration != generation) {
+            return;
+        }
+
+        if (shaped) {
+            cmd->setShaped(std::move(shaped));
+        } else if (!cmd->_shaped) {
+            cmd->_placeholderHeight = 0.0f;
+        } else {
+            return;
+        }
+        cmd->setLayout(node->_layout);
+        YGNodeMarkDirty(node->_node);
+        node->markLayoutDirty();
+        node->invalidateRasterCache();
+
+        root = node;
+        while (auto parent = root->_parent.lock()) {
+            root = std::move(parent);
+        }
+    }
+
+    root->requestRender();
+}
+
+void ParagraphCmd::setShaped(std::shared_ptr<ShapedParagraph> shaped)
+{
+    // A cache hit for unchanged text hands back the same paragraph, whose
+    // measurements and laid-out copy still hold.
+    if (_shaped == shaped) {
+        return;
+    }
+
+    _shaped = std::move(shaped);
+    this->props.paragraph = _shaped->paragraph;
+    _laidOut.reset();
+    _measureCacheCount = 0;
+    _measureCacheNext = 0;
+}
+
+YGSize ParagraphCmd::measure(float width, YGMeasureMode widthMode)
+{
+    std::lock_guard<std::mutex> lock(_shaped->mutex);
+    auto skParagraph = this->props.paragraph->getObject();
+    auto layoutWidth = width;
+    if (layoutWidth <= 0 || widthMode == YGMeasureModeUndefined) {
+        layoutShapedParagraph(*_shaped, kInitialParagraphLayoutWidth);
+        layoutWidth = skParagraph->getMaxIntrinsicWidth();
+    }
+    if (layoutWidth <= 0) {
+        layoutWidth = skParagraph->getLongestLine();
+    }
+    if (layoutWidth <= 0) {
+        return YGSize { 0, 0 };
+    }
+
+    layoutShapedParagraph(*_shaped, layoutWidth);
+    auto measuredWidth = layoutWidth;
+    if (widthMode == YGMeasureModeAtMost && width > 0) {
+        measuredWidth = std::min(width, layoutWidth);
+    }
+
+    return YGSize { .width = measuredWidth, .height = skParagraph->getHeight() };
+}
+
+// An undefined dimension arrives as NaN, so such requests only match each
+// other by mode.
+const YGSize* ParagraphCmd::findMeasurement(const MeasureCacheKey& key) const
+{
+    const auto matches = [](float cached, YGMeasureMode cachedMode, float requested, YGMeasureMode requestedMode) {
+        return cachedMode == requestedMode && (requestedMode == YGMeasureModeUndefined || cached == requested);
+    };
+
+    for (size_t index = 0; index < _measureCacheCount; ++index) {
+        const auto& entry = _measureCache[index];
+        if (matches(entry.key.width, entry.key.widthMode, key.width, key.widthMode) &&
+            matches(entry.key.height, entry.key.heightMode, key.height, key.heightMode)) {
+            return &entry.size;
+        }
+    }
+    return nullptr;
+}
+
+void ParagraphCmd::storeMeasurement(const MeasureCacheKey& key, YGSize size)
+{
+    _measureCache[_measureCacheNext] = MeasureCacheEntry { key, size };
+    _measureCacheNext = (_measureCacheNext + 1) % kMeasureCacheSize;
+    _measureCacheCount = std::min(_measureCacheCount + 1, kMeasureCacheSize);
 }
 
 void YogaNode::setLayout(const YogaNodeLayout& layout)
@@ -2279,15 +3808,57 @@ YogaNodeLayout YogaNode::getLayout()
     return _layout;
 }
 
-void ParagraphCmd::ensureDefaultParagraphResources()
+// The layout box, widened to the width the paragraph is laid out at (aligned
+// lines are placed within it) or its longest line, and extended to the text
+// height when the paragraph overflows its box.
+std::optional<SkRect> ParagraphCmd::localDrawBounds() const
+{
+    auto bounds = SkRect::MakeWH(node->_layout.width, node->_layout.height);
+    if (!_shaped) {
+        return bounds;
+    }
+
+    withLaidOutParagraph([&](para::Paragraph& paragraph, float width) {
+        bounds.join(SkRect::MakeWH(
+            std::max(width, static_cast<float>(paragraph.getLongestLine())),
+            paragraph.getHeight()));
+    });
+    return bounds;
+}
+
+// Paragraph bounds in yellow, or a red box where no paragraph was built.
+void ParagraphCmd::drawDebugOverlay(SkCanvas* canvas) const
 {
-    std::lock_guard<std::mutex> lock(sParagraphBuilderMutex);
-    if (sDefaultParagraphBuilder) {
+    const auto debugWidth = std::max(24.0f, this->props.width > 0 ? this->props.width : static_cast<float>(node->_layout.width));
+    const auto debugHeight = std::max(24.0f, static_cast<float>(node->_layout.height));
+
+    SkPaint debugPaint;
+    if (!this->props.paragraph) {
+        debugPaint.setStyle(SkPaint::kFill_Style);
+        debugPaint.setColor(SK_ColorRED);
+        canvas->drawRect(SkRect::MakeXYWH(this->props.x, this->props.y, debugWidth, debugHeight), debugPaint);
         return;
     }
 
-    if (!sDefaultParagraphStyle.has_value()) {
-        sDefaultParagraphStyle.emplace();
+    float paragraphHeight = 0.0f;
+    withLaidOutParagraph([&](para::Paragraph& paragraph, float) {
+        paragraphHeight = paragraph.getHeight();
+    });
+
+    debugPaint.setStyle(SkPaint::kStroke_Style);
+    debugPaint.setStrokeWidth(1.0f);
+    debugPaint.setColor(SK_ColorYELLOW);
+    canvas->drawRect(
+        SkRect::MakeXYWH(this->props.x, this->props.y, debugWidth, std::max(debugHeight, paragraphHeight)),
+        debugPaint);
+}
+
+// Every paragraph shares one font collection and unicode instance, so Skia's
+// typeface, fallback and shaping caches stay warm across updates.
+void ParagraphCmd::ensureDefaultParagraphResources()
+{
+    if (sDefaultFontCollection) {
+        return;
     }
 
     sDefaultFontCollection = sk_make_sp<para::FontCollection>();
@@ -2297,8 +3868,94 @@ void ParagraphCmd::ensureDefaultParagraphResources()
         sDefaultFontCollection->setDefaultFontManager(fontMgr);
     }
     sDefaultFontCollection->enableFontFallback();
+    sDefaultUnicode = makeUnicode();
+}
+
+// Builders are fixed to the paragraph style they were made with, so the pool
+// hands back one made for an equal style and only builds a new one otherwise.
+std::unique_ptr<para::ParagraphBuilder> ParagraphCmd::acquireParagraphBuilder(const para::ParagraphStyle& style)
+{
+    std::lock_guard<std::mutex> lock(sParagraphMutex);
+    for (auto it = sParagraphBuilderPool.rbegin(); it != sParagraphBuilderPool.rend(); ++it) {
+        if (sameParagraphStyle(it->first, style)) {
+            auto builder = std::move(it->second);
+            sParagraphBuilderPool.erase(std::next(it).base());
+            return builder;
+        }
+    }
+
+    ensureDefaultParagraphResources();
+    return para::ParagraphBuilder::make(style, sDefaultFontCollection, sDefaultUnicode);
+}
+
+void ParagraphCmd::releaseParagraphBuilder(const para::ParagraphStyle& style, std::unique_ptr<para::ParagraphBuilder> builder)
+{
+    builder->Reset();
+
+    std::lock_guard<std::mutex> lock(sParagraphMutex);
+    sParagraphBuilderPool.emplace_back(style, std::move(builder));
+    if (sParagraphBuilderPool.size() > kParagraphBuilderPoolSize) {
+        sParagraphBuilderPool.erase(sParagraphBuilderPool.begin());
+    }
+}
+
+// Shaping goes through the shared font collection, which is not thread safe,
+// so layout takes the paragraph mutex. Measuring at the width of the last
+// layout skips the layout entirely.
+void ParagraphCmd::layoutShapedParagraph(ShapedParagraph& shaped, float width)
+{
+    if (shaped.memoizesLayout && shaped.laidOutWidth == width) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(sParagraphMutex);
+    shaped.paragraph->getObject()->layout(width);
+    shaped.laidOutWidth = width;
+}
+
+// Nodes showing the same paragraph at the same width paint from one copy.
+// Building a copy is cheap next to the first build: the font collection
+// caches shaping by text and style, so its layout only breaks lines.
+std::shared_ptr<LaidOutParagraph> ParagraphCmd::layoutCopy(ShapedParagraph& shaped, float width)
+{
+    for (auto it = shaped.layouts.begin(); it != shaped.layouts.end(); ++it) {
+        if ((*it)->width == width) {
+            auto laidOut = *it;
+            shaped.layouts.erase(it);
+            shaped.layouts.push_back(laidOut);
+            return laidOut;
+        }
+    }
+
+    auto paragraph = buildParagraph(shaped.text, shaped.style);
+    if (!paragraph) {
+        return nullptr;
+    }
+
+    auto laidOut = std::make_shared<LaidOutParagraph>();
+    laidOut->paragraph = std::move(paragraph);
+    laidOut->width = width;
+    {
+        std::lock_guard<std::mutex> lock(sParagraphMutex);
+        laidOut->paragraph->getObject()->layout(width);
+    }
+
+    shaped.layouts.push_back(laidOut);
+    if (shaped.layouts.size() > kMaxParagraphLayouts) {
+        shaped.layouts.erase(shaped.layouts.begin());
+    }
+    return laidOut;
+}
+
+std::shared_ptr<LaidOutParagraph> ParagraphCmd::laidOutParagraph(float width) const
+{
+    if (_laidOut && _laidOut->width == width) {
+        return _laidOut;
+    }
 
-    sDefaultParagraphBuilder = para::ParagraphBuilder::make(*sDefaultParagraphStyle, sDefaultFontCollection, makeUnicode());
+    std::lock_guard<std::mutex> lock(_shaped->mutex);
+    _laidOut = layoutCopy(*_shaped, width);
+    return _laidOut;
 }
 
 // Factory used by generated RNSkiaYogaOnLoad.cpp to avoid including headers there
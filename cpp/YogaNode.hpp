@@ -1,5 +1,6 @@
 #pragma once
 
+#include "ParagraphCache.hpp"
 #include "PlatformContextAccessor.hpp"
 #include "SkiaGlue.hpp"
 #include "SkiaYoga.hpp"
@@ -37,6 +38,7 @@
 #include <include/core/SkFontMgr.h>
 #include <include/core/SkMaskFilter.h>
 #include <include/core/SkPathBuilder.h>
+#include <include/core/SkPicture.h>
 #include <include/core/SkSpan.h>
 #include <include/core/SkTypeface.h>
 #include <include/private/base/SkTypeTraits.h>
@@ -44,12 +46,16 @@
 #include <modules/skparagraph/include/ParagraphBuilder.h>
 #include <modules/skparagraph/include/ParagraphStyle.h>
 #include <algorithm>
+#include <array>
 #include <cmath>
+#include <cstdint>
+#include <functional>
 #include <limits>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 #include <yoga/Yoga.h>
 
@@ -318,6 +324,19 @@ namespace detail {
         return true;
     }
 
+    inline bool pointInRoundedRect(const ::SkPoint& point, const SkRRect& rrect)
+    {
+        return pointInRoundedRect(
+            point,
+            rrect.rect(),
+            CornerRadii {
+                rrect.radii(SkRRect::kUpperLeft_Corner),
+                rrect.radii(SkRRect::kUpperRight_Corner),
+                rrect.radii(SkRRect::kLowerRight_Corner),
+                rrect.radii(SkRRect::kLowerLeft_Corner),
+            });
+    }
+
 } // namespace detail
 
 class YogaNodeCommand {
@@ -327,6 +346,10 @@ public:
     virtual void setLayout(const YogaNodeLayout& layout) = 0;
     virtual void draw(RNSkia::DrawingCtx* ctx) = 0;
     virtual bool isDynamic() const { return false; }
+    virtual void collectAnimatedCells(std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells) const
+    {
+        (void)cells;
+    }
     virtual bool rasterizesSubtree() const { return false; }
     virtual bool supportsPreciseHitTesting() const { return false; }
     virtual std::optional<SkColor> fallbackPaintColor() const { return std::nullopt; }
@@ -335,6 +358,14 @@ public:
         (void)point;
         return false;
     }
+    // Local area the command draws into before paint effects. nullopt means
+    // the extent is unknown, so damage on the node repaints the whole view.
+    virtual std::optional<SkRect> localDrawBounds() const;
+    // Extra geometry for the per-view debug overlay, drawn in local space.
+    virtual void drawDebugOverlay(SkCanvas* canvas) const
+    {
+        (void)canvas;
+    }
 
 protected:
     explicit YogaNodeCommand(YogaNode* node)
@@ -375,6 +406,98 @@ struct HitSlopInsets {
     float left = 0.0f;
 };
 
+enum class YogaDisplayListOpKind {
+    SAVE,
+    SAVE_LAYER,
+    DRAW,
+    DELEGATE,
+    PICTURE,
+    RESTORE,
+};
+
+// One entry of a compiled display list. Matrices are absolute relative to the
+// canvas the list is replayed into, and DRAW ops carry the fully resolved paint,
+// so replay is a linear loop without tree walks or per-frame paint resolution.
+// DELEGATE hands a subtree that cannot be flattened back to drawInternal and
+// PICTURE replays the cached recording of a static subtree.
+struct YogaDisplayListOp {
+    YogaDisplayListOpKind kind;
+    YogaNode* node;
+    SkMatrix matrix;
+    SkPaint paint;
+    // Subtree bounds in the list's root space, nullopt when unbounded.
+    std::optional<SkRect> cullBounds;
+    // For SAVE and SAVE_LAYER, the index of the matching RESTORE so a culled
+    // subtree can be skipped in one step.
+    size_t restoreIndex = 0;
+};
+
+// State of one display-list compile. The previous list is kept so clean
+// subtrees move their ops over instead of being compiled again.
+struct YogaDisplayListCompile {
+    const YogaNode* listRoot;
+    std::vector<YogaDisplayListOp> previousOps;
+    // Zero when nothing in previousOps may be reused.
+    uint64_t previousGeneration;
+    uint64_t generation;
+    sk_sp<SkMaskFilter> maskFilter;
+};
+
+// Device bounds of one drawing op of a recorded snapshot and the nodes it
+// draws. Replays cull through the snapshot's R-tree, which reports nothing, so
+// the renderer counts culled nodes from these.
+struct YogaSnapshotCullEntry {
+    SkRect bounds;
+    size_t nodeCount;
+};
+
+// Hit-test candidates of a root's interactive nodes, flattened in paint order
+// so a later entry is on top of an earlier one. Matrices map from the root's
+// parent space to the node's local space; clips chain back to the ancestors
+// whose clipping still has to pass. Entries are bucketed into a uniform grid
+// over their bounds so a query only inspects the nodes near the point.
+struct YogaHitTestClip {
+    const YogaNode* node;
+    SkMatrix inverseMatrix;
+    int32_t parent;
+};
+
+struct YogaHitTestEntry {
+    const YogaNode* node;
+    SkMatrix inverseMatrix;
+    SkRect bounds;
+    int32_t clip;
+};
+
+struct YogaHitTestIndex {
+    std::vector<YogaHitTestClip> clips;
+    std::vector<YogaHitTestEntry> entries;
+    std::vector<std::vector<uint32_t>> cells;
+    SkRect bounds = SkRect::MakeEmpty();
+    int columns = 0;
+    int rows = 0;
+    float cellWidth = 0.0f;
+    float cellHeight = 0.0f;
+};
+
+// Holds the recursive mutex of the tree a node currently belongs to. Every node
+// of a tree shares its root's mutex, so work on one canvas never blocks
+// another. The pointer is re-checked after locking because reparenting can move
+// a node to a different tree while a thread is waiting.
+class YogaTreeLock {
+public:
+    explicit YogaTreeLock(const YogaNode& node);
+    YogaTreeLock(const YogaNode& first, const YogaNode& second);
+    ~YogaTreeLock();
+
+    YogaTreeLock(const YogaTreeLock&) = delete;
+    YogaTreeLock& operator=(const YogaTreeLock&) = delete;
+
+private:
+    std::shared_ptr<std::recursive_mutex> _mutex;
+    std::shared_ptr<std::recursive_mutex> _secondMutex;
+};
+
 class YogaNode : public HybridYogaNodeSpec {
 public:
     // This default constructor is required for autolinking in RNSkiaYogaAutolinking.mm
@@ -389,37 +512,84 @@ public:
 
     void computeLayout(std::optional<double> width, std::optional<double> height) override;
     void recursiveSetLayout();
+    void settleLayoutDirty();
     YogaNodeLayout getLayout() override;
     void setLayout(const YogaNodeLayout& layout) override;
     void invalidateLayout();
     void invalidateRasterCache();
+    void invalidatePaint();
+    void markLayoutDirty();
+    void markDamagePending();
+    void clearPaintDirty();
+    std::shared_ptr<std::recursive_mutex> treeMutex() const;
+    void adoptTreeMutex(const std::shared_ptr<std::recursive_mutex>& mutex);
+    void collectAnimatedCells(std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells);
+    void invalidateAnimatedCells();
+    void sampleAnimatedValues();
+    bool updateLayout();
+    void setRenderRequestCallback(std::function<void()> callback);
+    void requestRender();
 
     void removeAllChildren() override;
 
     jsi::Value draw(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count);
     jsi::Value hitTest(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count);
+    jsi::Value hitTestMany(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count);
     jsi::Value setInteractionConfig(jsi::Runtime& runtime, const jsi::Value& thisArg, const jsi::Value* args, size_t count);
+    sk_sp<SkPicture> recordSnapshot(float pixelDensity, std::vector<YogaSnapshotCullEntry>& cullEntries);
     void renderToContext(RNSkia::DrawingCtx& ctx);
+    SkRect collectDamage(const SkMatrix& baseMatrix);
+    void drawDebugOverlay(SkCanvas* canvas);
+    void drawDebugOverlayInternal(SkCanvas* canvas, const SkPaint& boundsPaint) const;
+    void accumulateDamage(const SkMatrix& parentMatrix, bool inheritsMaskFilter, SkRect& damage);
+    void updateDeviceBounds(const SkMatrix& parentMatrix, bool inheritsMaskFilter);
+    void joinDeviceBounds(const SkMatrix& matrix, bool inheritsMaskFilter);
+    SkMatrix localToParentMatrix(const SkMatrix& parentMatrix) const;
+    std::optional<SkRect> ownLocalBounds(bool inheritsMaskFilter) const;
+    void updateCullBounds(bool inheritsMaskFilter);
+    bool isOutsideClip(const SkRect& localClipBounds) const;
+    static size_t consumeCulledNodeCount();
     void drawInternal(RNSkia::DrawingCtx& ctx);
     void drawChildren(RNSkia::DrawingCtx& ctx);
+    void drawDisplayList(RNSkia::DrawingCtx& ctx);
+    void compileDisplayList(std::vector<YogaDisplayListOp>& ops, const SkMatrix& parentMatrix, YogaDisplayListCompile& compile, bool isListRoot);
+    void appendDisplayListOps(std::vector<YogaDisplayListOp>& ops, const SkMatrix& parentMatrix, YogaDisplayListCompile& compile, bool isListRoot);
+    bool spliceDisplayListOps(std::vector<YogaDisplayListOp>& ops, const SkMatrix& parentMatrix, YogaDisplayListCompile& compile);
+    bool updateSubtreeStatic();
+    const sk_sp<SkPicture>& ensurePictureCache();
+    bool flattensIntoDisplayList() const;
+    SkPaint resolveDrawPaint(const sk_sp<SkMaskFilter>& maskFilter) const;
+    void applyClips(SkCanvas* canvas) const;
     bool subtreeHasDynamicRasterContent() const;
     double hitTestTagAt(float x, float y);
     double hitTestInternal(const ::SkPoint& parentPoint) const;
+    bool usesHitTestIndex() const;
+    double hitTestIndexed(const ::SkPoint& point);
+    void buildHitTestIndex(YogaHitTestIndex& index, const SkMatrix& parentMatrix, int32_t clip) const;
+    void markHitTestIndexDirty();
+    void clearHitTestIndexDirty();
     bool containsSelfAtPoint(const ::SkPoint& point) const;
     bool pointPassesClipping(const ::SkPoint& point) const;
     void updateSelfInteractionState(bool isInteractive);
     void adjustInteractiveDescendantCount(int delta);
+    void applyClipStyle(const NodeStyle& style);
+    void applyMatrixStyle(const NodeStyle& style);
+    void updateClipGeometry();
 
     std::string getName() const { return "YogaNode"; }
 
     YGNodeRef _node;
+    mutable std::mutex _treeMutexGuard;
+    std::shared_ptr<std::recursive_mutex> _treeMutex = std::make_shared<std::recursive_mutex>();
     YogaNodeCommandKind _commandKind = YogaNodeCommandKind::NONE;
-    bool _hasLayoutBeenComputed = false;
+    bool _layoutDirty = true;
+    bool _paintDirty = true;
     YogaNodeLayout _layout;
     std::unique_ptr<YogaNodeCommand> _command;
     std::weak_ptr<YogaNode> _parent;
     std::vector<std::shared_ptr<YogaNode>> _children;
     NodeStyle _style;
+    bool _usesParagraphWidthDefault = false;
     SkPaint _paint;
     std::optional<SkPaint> _layerPaint;
     bool _clipsToBounds = false;
@@ -427,17 +597,57 @@ public:
     std::optional<SkRRect> _clipRRect;
     std::optional<detail::CornerRadii> _clipToBoundsRadii;
     std::optional<SkRect> _clipRect;
-    std::shared_ptr<SkMatrix> _matrix;
-    sk_sp<SkImage> _rasterCache;
+    // Derived from the clip style and layout size by updateClipGeometry.
+    std::optional<SkRRect> _clipToBoundsRRect;
+    std::optional<SkPath> _clipRRectPath;
+    std::optional<SkMatrix> _matrix;
+    // Value of style.matrix when it was last applied, for setStyle's diff.
+    std::optional<SkMatrix> _appliedStyleMatrix;
+    std::optional<SkMatrix> _inverseMatrix;
     bool _rasterCacheDirty = true;
-    int _rasterCacheHeight = 0;
-    int _rasterCacheWidth = 0;
+    std::vector<std::shared_ptr<AnimatedDoubleCell>> _animatedCells;
+    bool _animatedCellsDirty = true;
+    std::vector<YogaDisplayListOp> _displayList;
+    sk_sp<SkMaskFilter> _displayListMaskFilter;
+    bool _displayListCompiled = false;
+    uint64_t _displayListCompileGeneration = 0;
+    // Where this node's ops sit in the list that compiled it last, and the
+    // parent matrix they were compiled under.
+    const YogaNode* _displayListOwner = nullptr;
+    uint64_t _displayListGeneration = 0;
+    size_t _displayListBegin = 0;
+    size_t _displayListCount = 0;
+    SkMatrix _displayListParentMatrix;
+    sk_sp<SkPicture> _pictureCache;
+    bool _subtreeStatic = false;
+    // Damage tracking for partial redraws. _damagePending follows the dirty-bit
+    // invariant; _selfDamaged marks the node whose subtree area changed.
+    // _deviceBounds covers the subtree in the renderer's device space as of
+    // the last collectDamage.
+    bool _damagePending = true;
+    bool _selfDamaged = true;
+    bool _hasDeviceBounds = false;
+    SkRect _deviceBounds = SkRect::MakeEmpty();
+    SkMatrix _damageBaseMatrix;
+    // Clip culling bounds of the subtree in the parent's space; nullopt when
+    // unbounded. Maintained by updateCullBounds.
+    std::optional<SkRect> _cullBounds;
+    bool _hasCullBounds = false;
+    size_t _subtreeNodeCount = 1;
     PointerEventsMode _pointerEvents = PointerEventsMode::AUTO;
     HitSlopInsets _hitSlop;
     bool _preciseHit = false;
     bool _selfInteractive = false;
     int _interactiveDescendantCount = 0;
     double _eventTag = 0.0;
+    // Built lazily on roots with many interactive nodes; _hitTestIndexDirty
+    // follows the dirty-bit invariant.
+    std::unique_ptr<YogaHitTestIndex> _hitTestIndex;
+    bool _hitTestIndexDirty = true;
+    // Set on roots shown by a view; asks it for a frame when work finishing
+    // off the JS thread, such as background paragraph shaping, changed the tree.
+    std::mutex _renderRequestMutex;
+    std::function<void()> _renderRequestCallback;
 
     void loadHybridMethods() override
     {
@@ -448,6 +658,7 @@ public:
             prototype.registerRawHybridMethod("draw", 0, &YogaNode::draw);
             prototype.registerRawHybridMethod("getChildren", 0, &YogaNode::getChildren);
             prototype.registerRawHybridMethod("hitTest", 2, &YogaNode::hitTest);
+            prototype.registerRawHybridMethod("hitTestMany", 1, &YogaNode::hitTestMany);
             prototype.registerRawHybridMethod("setInteractionConfig", 1, &YogaNode::setInteractionConfig);
         });
     }
@@ -505,6 +716,10 @@ public:
         ctx->getPaint().setMaskFilter(maskFilter);
     }
     bool isDynamic() const override { return _blur.isDynamic(); }
+    void collectAnimatedCells(std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells) const override
+    {
+        _blur.collectCell(cells);
+    }
 
     void updateProps(const BlurMaskFilterCommandData& props);
 
@@ -529,10 +744,8 @@ public:
 
     void draw(RNSkia::DrawingCtx* ctx) override
     {
-        if (node->_clipToBoundsRadii.has_value()) {
-            ctx->canvas->drawRRect(
-                detail::makeRoundedRect(node->_layout, *node->_clipToBoundsRadii),
-                ctx->getPaint());
+        if (node->_clipToBoundsRRect.has_value()) {
+            ctx->canvas->drawRRect(*node->_clipToBoundsRRect, ctx->getPaint());
             return;
         }
 
@@ -581,6 +794,10 @@ public:
         RNSkia::RRectCmd::draw(ctx);
     }
     bool isDynamic() const override { return _cornerRadius.isDynamic(); }
+    void collectAnimatedCells(std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells) const override
+    {
+        _cornerRadius.collectCell(cells);
+    }
     bool supportsPreciseHitTesting() const override { return true; }
     bool containsLocalPoint(const ::SkPoint& point) const override
     {
@@ -680,6 +897,10 @@ public:
         RNSkia::CircleCmd::draw(ctx);
     }
     bool isDynamic() const override { return _radius.isDynamic(); }
+    void collectAnimatedCells(std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells) const override
+    {
+        _radius.collectCell(cells);
+    }
     bool supportsPreciseHitTesting() const override { return true; }
     bool containsLocalPoint(const ::SkPoint& point) const override
     {
@@ -705,6 +926,16 @@ public:
 
     bool hasExplicitRadius() const { return _hasExplicitRadius; }
 
+    std::optional<SkRect> localDrawBounds() const override
+    {
+        auto radius = this->props.r;
+        if (const auto resolvedRadius = _radius.resolveNativeFloat(); resolvedRadius.hasValue()) {
+            radius = resolvedRadius.value;
+        }
+        const auto center = this->props.c.value_or(::SkPoint { 0.0f, 0.0f });
+        return SkRect::MakeLTRB(center.fX - radius, center.fY - radius, center.fX + radius, center.fY + radius);
+    }
+
 private:
     AnimatedDouble _radius;
     bool _hasExplicitRadius = false;
@@ -748,10 +979,18 @@ public:
         RNSkia::TextCmd::draw(ctx);
     }
     std::optional<SkColor> fallbackPaintColor() const override { return _fallbackPaintColor; }
+    std::optional<SkRect> localDrawBounds() const override
+    {
+        auto bounds = SkRect::MakeWH(node->_layout.width, node->_layout.height);
+        bounds.join(_textBounds);
+        return bounds;
+    }
 
 private:
     static std::optional<SkFont> sDefaultFont;
     SkColor _fallbackPaintColor = SkPaint().getColor();
+    // Glyph bounds of the text as drawn, below the font-size baseline shift.
+    SkRect _textBounds = SkRect::MakeEmpty();
 };
 
 class ImageCmd : public RNSkia::ImageCmd, public YogaNodeCommand {
@@ -774,6 +1013,14 @@ public:
     }
 
     void draw(RNSkia::DrawingCtx* ctx) override { RNSkia::ImageCmd::draw(ctx); }
+    std::optional<SkRect> localDrawBounds() const override
+    {
+        auto bounds = SkRect::MakeWH(node->_layout.width, node->_layout.height);
+        if (this->props.rect.has_value()) {
+            bounds.join(*this->props.rect);
+        }
+        return bounds;
+    }
 };
 
 class PathCmd : public RNSkia::PathCmd, public YogaNodeCommand {
@@ -791,18 +1038,28 @@ public:
 
     void updateProps(const PathCommandData& props);
 
+    // The fitted path depends only on the base path and the layout size, so it
+    // is rebuilt only when the fit transform changes. Scaling on the canvas
+    // instead would also scale stroke widths.
     void setLayout(const YogaNodeLayout& layout) override
     {
-        this->props.path = _basePath;
         _baseLayout = layout;
 
-        auto bounds = _basePath.getBounds();
+        const auto transform = detail::calculateLayoutTransform(_basePath.getBounds(), layout);
+        if (_hasLayoutPath && transform == _layoutTransform) {
+            return;
+        }
 
-        const auto transform = detail::calculateLayoutTransform(bounds, layout);
-        this->props.path = SkPathBuilder(this->props.path).transform(transform).snapshot();
+        this->props.path = SkPathBuilder(_basePath).transform(transform).snapshot();
+        _layoutTransform = transform;
+        _hasLayoutPath = true;
     }
 
-    void setBasePath(const SkPath& path) { _basePath = path; }
+    void setBasePath(const SkPath& path)
+    {
+        _basePath = path;
+        _hasLayoutPath = false;
+    }
 
     void draw(RNSkia::DrawingCtx* ctx) override
     {
@@ -825,14 +1082,22 @@ public:
     {
         return _trimStart.isDynamic() || _trimEnd.isDynamic();
     }
+    void collectAnimatedCells(std::vector<std::shared_ptr<AnimatedDoubleCell>>& cells) const override
+    {
+        _trimStart.collectCell(cells);
+        _trimEnd.collectCell(cells);
+    }
     bool supportsPreciseHitTesting() const override { return true; }
     bool containsLocalPoint(const ::SkPoint& point) const override
     {
         return this->props.path.contains(point.fX, point.fY);
     }
+    std::optional<SkRect> localDrawBounds() const override { return this->props.path.getBounds(); }
 
 private:
     SkPath _basePath;
+    SkMatrix _layoutTransform;
+    bool _hasLayoutPath = false;
     AnimatedDouble _trimEnd;
     AnimatedDouble _trimStart;
 };
@@ -869,6 +1134,12 @@ public:
     const ::SkPoint& basePoint2() const { return _baseP2; }
 
     void draw(RNSkia::DrawingCtx* ctx) override { RNSkia::LineCmd::draw(ctx); }
+    std::optional<SkRect> localDrawBounds() const override
+    {
+        SkRect bounds;
+        bounds.setBounds(std::array<::SkPoint, 2> { this->props.p1, this->props.p2 }.data(), 2);
+        return bounds;
+    }
     bool supportsPreciseHitTesting() const override { return true; }
     bool containsLocalPoint(const ::SkPoint& point) const override
     {
@@ -916,10 +1187,12 @@ public:
         this->props.points = _basePoints;
 
         if (_basePoints.empty()) {
+            _layoutBounds.setEmpty();
             return;
         }
 
         const auto transform = detail::calculateLayoutTransform(_baseBounds, layout);
+        _layoutBounds = transform.mapRect(_baseBounds);
 
         const auto count = static_cast<size_t>(this->props.points.size());
         if (count > 0) {
@@ -937,6 +1210,8 @@ public:
     const std::vector<::SkPoint>& basePoints() const { return _basePoints; }
 
     void draw(RNSkia::DrawingCtx* ctx) override { RNSkia::PointsCmd::draw(ctx); }
+    // The stroke around each point is added by the node's paint bounds.
+    std::optional<SkRect> localDrawBounds() const override { return _layoutBounds; }
     bool supportsPreciseHitTesting() const override { return true; }
     bool containsLocalPoint(const ::SkPoint& point) const override
     {
@@ -978,6 +1253,7 @@ private:
 
     std::vector<::SkPoint> _basePoints;
     SkRect _baseBounds;
+    SkRect _layoutBounds = SkRect::MakeEmpty();
 };
 
 class ParagraphCmd : public RNSkia::ParagraphCmd, public YogaNodeCommand {
@@ -992,7 +1268,9 @@ public:
         this->props.y = 0;
     }
 
-    void updateProps(const ParagraphCommandData& props);
+    // Returns whether the measured content changed, so the node only needs a
+    // new layout when it did.
+    bool updateProps(const ParagraphCommandData& props);
 
     void setLayout(const YogaNodeLayout& layout) override
     {
@@ -1001,36 +1279,16 @@ public:
 
     void draw(RNSkia::DrawingCtx* ctx) override
     {
-        SkPaint debugPaint;
-        const auto debugWidth = std::max(24.0f, this->props.width > 0 ? this->props.width : static_cast<float>(node->_layout.width));
-        const auto debugHeight = std::max(24.0f, static_cast<float>(node->_layout.height));
-
         if (!this->props.paragraph) {
-            debugPaint.setStyle(SkPaint::kFill_Style);
-            debugPaint.setColor(SK_ColorRED);
-            ctx->canvas->drawRect(
-                SkRect::MakeXYWH(this->props.x, this->props.y, debugWidth, debugHeight),
-                debugPaint);
             return;
         }
 
-        auto paragraph = this->props.paragraph->getObject();
-        auto layoutWidth = this->props.width > 0 ? this->props.width : kInitialParagraphLayoutWidth;
-        paragraph->layout(layoutWidth);
-
-        debugPaint.setStyle(SkPaint::kStroke_Style);
-        debugPaint.setStrokeWidth(1.0f);
-        debugPaint.setColor(SK_ColorYELLOW);
-        ctx->canvas->drawRect(
-            SkRect::MakeXYWH(
-                this->props.x,
-                this->props.y,
-                debugWidth,
-                std::max(debugHeight, paragraph->getHeight())),
-            debugPaint);
-
-        paragraph->paint(ctx->canvas, this->props.x, this->props.y);
+        withLaidOutParagraph([&](para::Paragraph& paragraph, float) {
+            paragraph.paint(ctx->canvas, this->props.x, this->props.y);
+        });
     }
+    std::optional<SkRect> localDrawBounds() const override;
+    void drawDebugOverlay(SkCanvas* canvas) const override;
 
     static YGSize measureFunc(YGNodeConstRef node, float width, YGMeasureMode widthMode, float height, YGMeasureMode heightMode)
     {
@@ -1038,38 +1296,130 @@ public:
 
         auto cmd = static_cast<ParagraphCmd*>(paragraph->_command.get());
 
-        if (!cmd || !cmd->props.paragraph) {
+        if (!cmd) {
             return YGSize { 0, 0 };
         }
-
-        auto skParagraph = cmd->props.paragraph->getObject();
-        auto layoutWidth = width;
-        if (layoutWidth <= 0 || widthMode == YGMeasureModeUndefined) {
-            skParagraph->layout(kInitialParagraphLayoutWidth);
-            layoutWidth = skParagraph->getMaxIntrinsicWidth();
+        if (!cmd->_shaped) {
+            // Still shaping in the background: reserve one line, which is
+            // the final height of most labels.
+            const auto placeholderWidth = widthMode == YGMeasureModeExactly ? width : 0.0f;
+            return YGSize { .width = placeholderWidth, .height = cmd->_placeholderHeight };
         }
-        if (layoutWidth <= 0) {
-            layoutWidth = skParagraph->getLongestLine();
+
+        // Yoga drops its own measurements whenever the node is marked dirty,
+        // but a shaped paragraph measures the same until its text changes.
+        const MeasureCacheKey key { width, widthMode, height, heightMode };
+        if (const auto* cached = cmd->findMeasurement(key)) {
+            return *cached;
         }
-        if (layoutWidth <= 0) {
-            return YGSize { 0, 0 };
+
+        const auto size = cmd->measure(width, widthMode);
+        cmd->storeMeasurement(key, size);
+        return size;
+    }
+
+    static float baselineFunc(YGNodeConstRef node, float width, float height)
+    {
+        auto paragraph = static_cast<YogaNode*>(YGNodeGetContext(node));
+
+        auto cmd = static_cast<ParagraphCmd*>(paragraph->_command.get());
+
+        if (!cmd || !cmd->_shaped || std::isnan(width) || width <= 0) {
+            return height;
         }
 
-        skParagraph->layout(layoutWidth);
-        auto measuredWidth = layoutWidth;
-        if (widthMode == YGMeasureModeAtMost && width > 0) {
-            measuredWidth = std::min(width, layoutWidth);
+        // Measuring laid the paragraph out at this width already, so this
+        // is normally a lookup.
+        std::lock_guard<std::mutex> lock(cmd->_shaped->mutex);
+        layoutShapedParagraph(*cmd->_shaped, width);
+        return cmd->props.paragraph->getObject()->getAlphabeticBaseline();
+    }
+
+    static constexpr size_t kParagraphBuilderPoolSize = 8;
+
+    static std::unique_ptr<para::ParagraphBuilder> acquireParagraphBuilder(const para::ParagraphStyle& style);
+    static void releaseParagraphBuilder(const para::ParagraphStyle& style, std::unique_ptr<para::ParagraphBuilder> builder);
+
+private:
+    static constexpr float kPlaceholderLineHeightScale = 1.2f;
+    static constexpr size_t kMeasureCacheSize = 4;
+    static constexpr size_t kMaxParagraphLayouts = 4;
+
+    struct MeasureCacheKey {
+        float width;
+        YGMeasureMode widthMode;
+        float height;
+        YGMeasureMode heightMode;
+    };
+
+    struct MeasureCacheEntry {
+        MeasureCacheKey key;
+        YGSize size;
+    };
+
+    void applyProps(const ParagraphCommandData& props);
+    YGSize measure(float width, YGMeasureMode widthMode);
+    const YGSize* findMeasurement(const MeasureCacheKey& key) const;
+    void storeMeasurement(const MeasureCacheKey& key, YGSize size);
+    void setShaped(std::shared_ptr<ShapedParagraph> shaped);
+
+    float layoutWidth() const
+    {
+        return this->props.width > 0 ? this->props.width : kInitialParagraphLayoutWidth;
+    }
+
+    // Calls fn with the paragraph laid out at this node's width, holding only
+    // that paragraph's own mutex: a per-width copy for built paragraphs, the
+    // paragraph itself for ones passed in from JS.
+    template <typename Fn>
+    void withLaidOutParagraph(Fn&& fn) const
+    {
+        const auto width = layoutWidth();
+        if (!_shaped->memoizesLayout) {
+            std::lock_guard<std::mutex> lock(_shaped->mutex);
+            layoutShapedParagraph(*_shaped, width);
+            fn(*_shaped->paragraph->getObject(), width);
+            return;
         }
 
-        return YGSize { .width = measuredWidth, .height = skParagraph->getHeight() };
+        auto laidOut = laidOutParagraph(width);
+        if (!laidOut) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(laidOut->mutex);
+        fn(*laidOut->paragraph->getObject(), width);
     }
+    std::shared_ptr<LaidOutParagraph> laidOutParagraph(float width) const;
 
+    // Requires sParagraphMutex.
     static void ensureDefaultParagraphResources();
-
-    static std::mutex sParagraphBuilderMutex;
-    static std::unique_ptr<para::ParagraphBuilder> sDefaultParagraphBuilder;
+    // Require shaped.mutex.
+    static void layoutShapedParagraph(ShapedParagraph& shaped, float width);
+    static std::shared_ptr<LaidOutParagraph> layoutCopy(ShapedParagraph& shaped, float width);
+
+    static std::shared_ptr<RNSkia::JsiSkParagraph> buildParagraph(const std::string& text, const para::ParagraphStyle& style);
+    static std::shared_ptr<ShapedParagraph> shapeParagraph(const std::string& text, const para::ParagraphStyle& style);
+    static void finishShaping(const std::shared_ptr<YogaNode>& node, uint64_t generation, std::shared_ptr<ShapedParagraph> shaped);
+
+    std::shared_ptr<ShapedParagraph> _shaped;
+    // The copy of _shaped this node last painted from.
+    mutable std::shared_ptr<LaidOutParagraph> _laidOut;
+    // Bumped by every update, so a background shaping job that was overtaken
+    // by newer props drops its result.
+    uint64_t _shapingGeneration = 0;
+    float _placeholderHeight = 0.0f;
+    // Recent measurements of _shaped, replaced round-robin.
+    std::array<MeasureCacheEntry, kMeasureCacheSize> _measureCache;
+    size_t _measureCacheCount = 0;
+    size_t _measureCacheNext = 0;
+
+    // Guards the shared font collection, whose typeface and shaping caches are
+    // used by every paragraph build and layout, and the builder pool. Never
+    // held while painting.
+    static std::mutex sParagraphMutex;
     static sk_sp<para::FontCollection> sDefaultFontCollection;
-    static std::optional<para::ParagraphStyle> sDefaultParagraphStyle;
+    static sk_sp<SkUnicode> sDefaultUnicode;
+    static std::vector<std::pair<para::ParagraphStyle, std::unique_ptr<para::ParagraphBuilder>>> sParagraphBuilderPool;
 };
 
 } // namespace margelo::nitro::RNSkiaYoga
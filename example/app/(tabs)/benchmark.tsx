@@ -440,6 +440,15 @@ export default function BenchmarkScreen() {
 							Native frames/sample:{" "}
 							{formatMetric(profileSample?.frames ?? 0, 0)}
 						</Text>
+						<Text style={styles.metricLine}>
+							Yoga layout:{" "}
+							{formatMetric(profileSample?.avgLayoutMs ?? 0)} ms
+						</Text>
+						<Text style={styles.metricLine}>
+							Commit layout:{" "}
+							{formatMetric(profileSample?.avgCommitLayoutMs ?? 0)}{" "}
+							ms
+						</Text>
 						<Text style={styles.metricLine}>
 							Yoga draw:{" "}
 							{formatMetric(profileSample?.avgDrawMs ?? 0)} ms
@@ -25,11 +25,20 @@ type YogaCanvasProps = CanvasProps & {
 }
 
 export type YogaCanvasProfileSample = {
+	avgCommitLayoutMs: number
 	avgDrawMs: number
+	avgLayoutMs: number
 	avgPresentMs: number
+	culledNodes: number
 	frames: number
+	maxCommitLayoutMs: number
 	maxDrawMs: number
+	maxLayoutMs: number
 	maxPresentMs: number
+	rasterCacheBytes: number
+	rasterCacheEvictions: number
+	rasterCacheHits: number
+	rasterCacheMisses: number
 	rawInvalidateCalls: number
 	sampleDurationMs: number
 	scheduledInvalidateCalls: number
@@ -39,11 +48,20 @@ export type YogaCanvasProfileSample = {
 const INITIAL_RENDER_RETRY_FRAMES = 8
 
 type NativeProfilePayload = {
+	avgCommitLayoutMs?: unknown
 	avgDrawMs?: unknown
+	avgLayoutMs?: unknown
 	avgPresentMs?: unknown
+	culledNodes?: unknown
 	frames?: unknown
+	maxCommitLayoutMs?: unknown
 	maxDrawMs?: unknown
+	maxLayoutMs?: unknown
 	maxPresentMs?: unknown
+	rasterCacheBytes?: unknown
+	rasterCacheEvictions?: unknown
+	rasterCacheHits?: unknown
+	rasterCacheMisses?: unknown
 	sampleDurationMs?: unknown
 }
 
@@ -124,11 +142,22 @@ export function YogaCanvas({
 
 			const frames = nativeFrames > 0 ? nativeFrames : profile.frames
 			onProfileSample({
+				avgCommitLayoutMs: toFiniteNumber(nativeSample.avgCommitLayoutMs),
 				avgDrawMs: toFiniteNumber(nativeSample.avgDrawMs),
+				avgLayoutMs: toFiniteNumber(nativeSample.avgLayoutMs),
 				avgPresentMs: toFiniteNumber(nativeSample.avgPresentMs),
+				culledNodes: toFiniteNumber(nativeSample.culledNodes),
 				frames,
+				maxCommitLayoutMs: toFiniteNumber(nativeSample.maxCommitLayoutMs),
 				maxDrawMs: toFiniteNumber(nativeSample.maxDrawMs),
+				maxLayoutMs: toFiniteNumber(nativeSample.maxLayoutMs),
 				maxPresentMs: toFiniteNumber(nativeSample.maxPresentMs),
+				rasterCacheBytes: toFiniteNumber(nativeSample.rasterCacheBytes),
+				rasterCacheEvictions: toFiniteNumber(
+					nativeSample.rasterCacheEvictions,
+				),
+				rasterCacheHits: toFiniteNumber(nativeSample.rasterCacheHits),
+				rasterCacheMisses: toFiniteNumber(nativeSample.rasterCacheMisses),
 				rawInvalidateCalls: profile.rawInvalidateCalls,
 				sampleDurationMs,
 				scheduledInvalidateCalls: profile.scheduledInvalidateCalls,
@@ -9,5 +9,6 @@ export interface YogaNodeFinal extends YogaNode {
 	draw(): any
 	getChildren(): YogaNodeFinal[]
 	hitTest(x: number, y: number): number
+	hitTestMany(points: Float32Array): number[]
 	setInteractionConfig(config: YogaNodeInteractionConfig): void
 }